@@ -7,6 +7,7 @@
  *
  */
 #include <Arduino.h>
+#include <esp_heap_caps.h>
 #include "LV_Helper.h"
 
 
@@ -17,16 +18,127 @@
 static lv_disp_draw_buf_t draw_buf;
 static lv_disp_drv_t disp_drv;
 static lv_indev_drv_t  indev_drv;
+static lv_helper_flush_stats_t flush_stats;
+static uint32_t frame_bytes;
+static uint32_t frame_rects;
+static uint32_t frame_us;
+static bool push_pending;
+static uint32_t wait_start_us;
 
 /* Display flushing */
 static void disp_flush( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p )
 {
     uint32_t w = ( area->x2 - area->x1 + 1 );
     uint32_t h = ( area->y2 - area->y1 + 1 );
-    static_cast<LilyGo_Display *>(disp_drv->user_data)->pushColors(area->x1, area->y1, w, h, (uint16_t *)color_p);
+    LilyGo_Display *board = static_cast<LilyGo_Display *>(disp_drv->user_data);
+    uint32_t start = micros();
+    bool queued = false;
+    if (flush_stats.async) {
+        queued = board->pushColorsAsync(area->x1, area->y1, w, h, (uint16_t *)color_p);
+    } else {
+        board->pushColors(area->x1, area->y1, w, h, (uint16_t *)color_p);
+    }
+    uint32_t elapsed = micros() - start;
+    flush_stats.flush_us += elapsed;
+
+    frame_bytes += w * h * sizeof(lv_color_t);
+    frame_rects++;
+    frame_us += elapsed;
+    if (lv_disp_flush_is_last(disp_drv)) {
+        flush_stats.frames++;
+        flush_stats.last_frame_bytes = frame_bytes;
+        flush_stats.last_frame_rects = frame_rects;
+        flush_stats.last_frame_us = frame_us;
+        flush_stats.max_frame_bytes = max(flush_stats.max_frame_bytes, frame_bytes);
+        flush_stats.total_bytes += frame_bytes;
+        frame_bytes = 0;
+        frame_rects = 0;
+        frame_us = 0;
+    }
+
+    if (queued) {
+        // Released from disp_wait() once the transfer has finished
+        push_pending = true;
+        wait_start_us = 0;
+        return;
+    }
+    flush_stats.wire_us += elapsed;
+    lv_disp_flush_ready( disp_drv );
+}
+
+/* Called by LVGL while it needs the buffer that is still being sent */
+static void disp_wait( lv_disp_drv_t *disp_drv )
+{
+    if (!push_pending) {
+        return;
+    }
+
+    LilyGo_Display *board = static_cast<LilyGo_Display *>(disp_drv->user_data);
+    if (!board->pushDone()) {
+        if (wait_start_us == 0) {
+            wait_start_us = micros() | 1;
+        }
+        return;
+    }
+
+    if (wait_start_us != 0) {
+        flush_stats.wait_us += micros() - wait_start_us;
+    }
+    flush_stats.wire_us += board->lastPushUs();
+    push_pending = false;
     lv_disp_flush_ready( disp_drv );
 }
 
+#if LV_HELPER_DAMAGE_FLUSH
+/*
+ * Runs on every lv_timer_handler() pass, ahead of the display refresh
+ * (timers created later are handled first), and greedily merges the
+ * pending invalid areas, cheapest union first, until few enough remain.
+ * Every area is already even-aligned by lv_rounder_cb, so their bounding
+ * boxes are too.
+ */
+static void coalesce_damage_cb(lv_timer_t *timer)
+{
+    lv_disp_t *disp = (lv_disp_t *)timer->user_data;
+
+    // A full-screen area has nothing left to merge
+    if (disp->inv_p <= 1) {
+        return;
+    }
+
+    for (;;) {
+        int best_i = -1;
+        int best_j = -1;
+        int32_t best_cost = 0;
+
+        for (int i = 0; i < disp->inv_p; i++) {
+            for (int j = i + 1; j < disp->inv_p; j++) {
+                lv_area_t joined;
+                _lv_area_join(&joined, &disp->inv_areas[i], &disp->inv_areas[j]);
+                // Extra pixels pushed if the two become one rectangle
+                int32_t cost = (int32_t)lv_area_get_size(&joined) -
+                               (int32_t)lv_area_get_size(&disp->inv_areas[i]) -
+                               (int32_t)lv_area_get_size(&disp->inv_areas[j]);
+                if (best_i < 0 || cost < best_cost) {
+                    best_i = i;
+                    best_j = j;
+                    best_cost = cost;
+                }
+            }
+        }
+
+        // Free merges always happen; paid ones only to respect the cap
+        if (best_i < 0 || (best_cost > 0 && disp->inv_p <= LV_HELPER_MAX_DAMAGE_RECTS)) {
+            break;
+        }
+
+        _lv_area_join(&disp->inv_areas[best_i], &disp->inv_areas[best_i], &disp->inv_areas[best_j]);
+        disp->inv_areas[best_j] = disp->inv_areas[disp->inv_p - 1];
+        disp->inv_p--;
+    }
+}
+#endif
+
 /*Read the touchpad*/
 static void touchpad_read( lv_indev_drv_t *indev_driver, lv_indev_data_t *data )
 {
@@ -45,6 +157,7 @@ static void touchpad_read( lv_indev_drv_t *indev_driver, lv_indev_data_t *data )
 #error "Please turn on PSRAM to OPI !"
 #else
 static lv_color_t *buf = NULL;
+static lv_color_t *buf2 = NULL;
 #endif
 
 #if LV_USE_LOG
@@ -79,11 +192,34 @@ void beginLvglHelper(LilyGo_Display &board, bool debug)
     }
 #endif
 
-    size_t lv_buffer_size = board.width() * board.height() * sizeof(lv_color_t);
-    buf = (lv_color_t *)ps_malloc(lv_buffer_size);
-    assert(buf);
+    // The panel decides; the SH8501 (1.47") still asks for full refresh and
+    // partial areas have not been verified on it
+    bool full_refresh = board.needFullRefresh();
+
+    // Partial refresh can render into two small internal-RAM strips that
+    // the SPI DMA reads directly; full refresh needs a whole-screen buffer
+    if (!full_refresh) {
+        size_t strip_size = board.width() * LV_HELPER_DMA_BUF_LINES * sizeof(lv_color_t);
+        buf = (lv_color_t *)heap_caps_malloc(strip_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        buf2 = (lv_color_t *)heap_caps_malloc(strip_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!buf || !buf2) {
+            free(buf);
+            free(buf2);
+            buf = NULL;
+            buf2 = NULL;
+        }
+    }
+
+    if (buf2) {
+        flush_stats.async = true;
+        lv_disp_draw_buf_init( &draw_buf, buf, buf2, board.width() * LV_HELPER_DMA_BUF_LINES);
+    } else {
+        size_t lv_buffer_size = board.width() * board.height() * sizeof(lv_color_t);
+        buf = (lv_color_t *)ps_malloc(lv_buffer_size);
+        assert(buf);
 
-    lv_disp_draw_buf_init( &draw_buf, buf, NULL, board.width() * board.height());
+        lv_disp_draw_buf_init( &draw_buf, buf, NULL, board.width() * board.height());
+    }
 
     /*Initialize the display*/
     lv_disp_drv_init( &disp_drv );
@@ -91,14 +227,20 @@ void beginLvglHelper(LilyGo_Display &board, bool debug)
     disp_drv.hor_res = board.width();
     disp_drv.ver_res = board.height();
     disp_drv.flush_cb = disp_flush;
+    disp_drv.wait_cb = disp_wait;
     disp_drv.draw_buf = &draw_buf;
-    bool full_refresh = board.needFullRefresh();
     disp_drv.full_refresh = full_refresh;
     disp_drv.user_data = &board;
     if (!full_refresh) {
         disp_drv.rounder_cb = lv_rounder_cb;
     }
-    lv_disp_drv_register( &disp_drv );
+    lv_disp_t *disp = lv_disp_drv_register( &disp_drv );
+
+#if LV_HELPER_DAMAGE_FLUSH
+    if (!full_refresh) {
+        lv_timer_create(coalesce_damage_cb, 0, disp);
+    }
+#endif
 
     if (board.hasTouch()) {
         lv_indev_drv_init( &indev_drv );
@@ -108,3 +250,8 @@ void beginLvglHelper(LilyGo_Display &board, bool debug)
         lv_indev_drv_register( &indev_drv );
     }
 }
+
+const lv_helper_flush_stats_t &lvglHelperFlushStats()
+{
+    return flush_stats;
+}
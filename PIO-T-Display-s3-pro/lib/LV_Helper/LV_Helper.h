@@ -12,4 +12,36 @@
 #include "LilyGo_Display.h"
 
 
+// On panels that allow partial refresh, merge what LVGL invalidated into a
+// few rectangles per frame. Set to 0 to restore the old behaviour.
+#ifndef LV_HELPER_DAMAGE_FLUSH
+#define LV_HELPER_DAMAGE_FLUSH      1
+#endif
+
+// Invalid areas are merged down to at most this many rectangles per frame
+#ifndef LV_HELPER_MAX_DAMAGE_RECTS
+#define LV_HELPER_MAX_DAMAGE_RECTS  4
+#endif
+
+// Lines per draw buffer when two DMA-capable strips are used; LVGL renders
+// into one while the other is on the wire
+#ifndef LV_HELPER_DMA_BUF_LINES
+#define LV_HELPER_DMA_BUF_LINES     24
+#endif
+
+typedef struct {
+    uint32_t frames;            // Frames flushed since boot
+    uint32_t last_frame_bytes;  // Pixel bytes pushed for the last frame
+    uint32_t last_frame_rects;  // Flush calls for the last frame
+    uint32_t last_frame_us;     // Time in the flush callback for the last frame
+    uint32_t max_frame_bytes;
+    uint64_t total_bytes;
+    bool     async;             // Double DMA buffers with queued pushes
+    uint64_t flush_us;          // CPU time spent inside the flush callback
+    uint64_t wire_us;           // Time the pixels spent on the bus
+    uint64_t wait_us;           // Time LVGL sat waiting for a push to end
+} lv_helper_flush_stats_t;
+
 void beginLvglHelper(LilyGo_Display &board, bool debug = false);
+
+const lv_helper_flush_stats_t &lvglHelperFlushStats();
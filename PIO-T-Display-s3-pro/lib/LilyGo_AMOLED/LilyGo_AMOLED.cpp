@@ -10,7 +10,10 @@
 #include "LilyGo_AMOLED.h"
 #include <esp_adc_cal.h>
 #include <driver/gpio.h>
+#include <esp_timer.h>
+#include <soc/gpio_struct.h>
 #include "RM67162_AMOLED_SPI.h"
+#include "RotateBlit.h"
 
 #define SEND_BUF_SIZE           (16384)
 #define TFT_SPI_MODE            SPI_MODE0
@@ -21,6 +24,11 @@ LilyGo_AMOLED::LilyGo_AMOLED() : boards(NULL)
     panel_handle = NULL;
     pBuffer = NULL;
     spi = NULL;
+    _queuedTrans = 0;
+    _pushCs = -1;
+    _pushBusy = false;
+    _pushStartUs = 0;
+    _lastPushUs = 0;
     _brightness = AMOLED_DEFAULT_BRIGHTNESS;
     // Prevent previously set hold
     switch (esp_sleep_get_wakeup_cause()) {
@@ -348,7 +356,8 @@ bool LilyGo_AMOLED::initBUS()
         .clock_speed_hz = boards->display.freq,
         .spics_io_num = -1,
         .flags = SPI_DEVICE_HALFDUPLEX,
-        .queue_size = 17,
+        .queue_size = AMOLED_PUSH_QUEUE_SIZE,
+        .post_cb = pushCompleteISR,
     };
     esp_err_t ret = spi_bus_initialize(DEFAULT_SPI_HANDLER, &buscfg, SPI_DMA_CH_AUTO);
     if (ret != ESP_OK) {
@@ -696,6 +705,7 @@ void LilyGo_AMOLED::writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length)
     }
 
     // QSPI
+    waitPushDone();
     setCS();
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));
@@ -773,6 +783,7 @@ void LilyGo_AMOLED::pushColors(uint16_t *data, uint32_t len)
     uint16_t *p = data;
     assert(p);
     assert(spi);
+    waitPushDone();
     setCS();
     do {
         size_t chunk_size = len;
@@ -810,14 +821,7 @@ void LilyGo_AMOLED::pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t
         uint16_t _y = x;
         uint16_t _h = width;
         uint16_t _w = hight;
-        uint16_t *p = data;
-        uint32_t cum = 0;
-        for (uint16_t j = 0; j < width; j++) {
-            for (uint16_t i = 0; i < hight; i++) {
-                pBuffer[cum] = ((uint16_t)p[width * (hight - i - 1) + j]);
-                cum++;
-            }
-        }
+        rotateBlit(pBuffer, data, width, hight);
         setAddrWindow(_x, _y, _x + _w - 1, _y + _h - 1);
         pushColors(pBuffer, width * hight);
     } else {
@@ -826,6 +830,96 @@ void LilyGo_AMOLED::pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t
     }
 }
 
+// Runs from the SPI ISR after every transaction; only the last chunk of a
+// queued push carries the owner in t->user
+void IRAM_ATTR LilyGo_AMOLED::pushCompleteISR(spi_transaction_t *t)
+{
+    LilyGo_AMOLED *self = (LilyGo_AMOLED *)t->user;
+    if (self == NULL) {
+        return;
+    }
+
+    // Release CS with a register write; digitalWrite and the flash-resident
+    // board table are not safe to touch from here
+    int cs = self->_pushCs;
+    if (cs < 32) {
+        GPIO.out_w1ts = (1UL << cs);
+    } else {
+        GPIO.out1_w1ts.val = (1UL << (cs - 32));
+    }
+
+    self->_lastPushUs = (uint32_t)(esp_timer_get_time() - self->_pushStartUs);
+    self->_pushBusy = false;
+}
+
+// Collect finished queued transactions so polling transfers can run again
+void LilyGo_AMOLED::waitPushDone()
+{
+    spi_transaction_t *rt;
+    while (_queuedTrans > 0) {
+        spi_device_get_trans_result(spi, &rt, portMAX_DELAY);
+        _queuedTrans--;
+    }
+}
+
+bool LilyGo_AMOLED::pushColorsAsync(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data)
+{
+    // The SPI panel and the rotating framebuffer path stay synchronous
+    if (panel_handle || boards->display.frameBufferSize) {
+        pushColors(x, y, width, hight, data);
+        return false;
+    }
+
+    uint32_t len = width * hight;
+    assert((len + SEND_BUF_SIZE - 1) / SEND_BUF_SIZE <= AMOLED_PUSH_QUEUE_SIZE);
+
+    setAddrWindow(x, y, x + width - 1, y + hight - 1);
+
+    bool first_send = true;
+    uint16_t *p = data;
+    _pushCs = boards->display.cs;
+    _pushBusy = true;
+    _pushStartUs = esp_timer_get_time();
+    setCS();
+    do {
+        size_t chunk_size = len;
+        spi_transaction_ext_t &t = _pushTrans[_queuedTrans];
+        memset(&t, 0, sizeof(t));
+        if (first_send) {
+            t.base.flags = SPI_TRANS_MODE_QIO;
+            t.base.cmd = 0x32 ;
+            t.base.addr = 0x002C00;
+            first_send = 0;
+        } else {
+            t.base.flags = SPI_TRANS_MODE_QIO | SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY;
+            t.command_bits = 0;
+            t.address_bits = 0;
+            t.dummy_bits = 0;
+        }
+        if (chunk_size > SEND_BUF_SIZE) {
+            chunk_size = SEND_BUF_SIZE;
+        }
+        t.base.tx_buffer = p;
+        t.base.length = chunk_size * 16;
+        len -= chunk_size;
+        p += chunk_size;
+        t.base.user = (len == 0) ? this : NULL;
+        spi_device_queue_trans(spi, (spi_transaction_t *)&t, portMAX_DELAY);
+        _queuedTrans++;
+    } while (len > 0);
+    return true;
+}
+
+bool LilyGo_AMOLED::pushDone()
+{
+    return !_pushBusy;
+}
+
+uint32_t LilyGo_AMOLED::lastPushUs()
+{
+    return _lastPushUs;
+}
+
 
 void LilyGo_AMOLED::beginCore()
 {
@@ -34,6 +34,9 @@
 
 #include <esp_lcd_types.h>
 
+// SPI transactions that may be queued for one pixel push
+#define AMOLED_PUSH_QUEUE_SIZE  17
+
 
 #if ARDUINO_USB_CDC_ON_BOOT != 1
 #warning "If you need to monitor printed data, be sure to set USB_CDC_ON_BOOT to ENABLE, otherwise you will not see any data in the serial monitor"
@@ -350,6 +353,9 @@ public:
     void setAddrWindow(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye);
     void pushColors(uint16_t *data, uint32_t len);
     void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data);
+    bool pushColorsAsync(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data) override;
+    bool pushDone() override;
+    uint32_t lastPushUs() override;
 
 
     bool installSD(int miso = -1, int mosi = -1, int sclk = -1, int cs = -1);
@@ -394,7 +400,16 @@ private:
     void inline setCS();
     void inline clrCS();
     void writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length);
+    void waitPushDone();
+    static void IRAM_ATTR pushCompleteISR(spi_transaction_t *t);
     uint16_t *pBuffer;
+    // Queued pixel transfer; the transactions must outlive the call
+    spi_transaction_ext_t _pushTrans[AMOLED_PUSH_QUEUE_SIZE];
+    uint32_t _queuedTrans;
+    int _pushCs;
+    volatile bool _pushBusy;
+    volatile int64_t _pushStartUs;
+    volatile uint32_t _lastPushUs;
     spi_device_handle_t spi;
     uint8_t _brightness;
     const BoardsConfigure_t *boards;
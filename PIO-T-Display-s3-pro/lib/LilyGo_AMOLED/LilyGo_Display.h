@@ -32,6 +32,23 @@ public:
 
     virtual bool needFullRefresh() = 0;
 
+    // Queued (DMA) push. Returns false when the pixels were already sent
+    // synchronously; otherwise poll pushDone() before reusing the buffer.
+    virtual bool pushColorsAsync(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data)
+    {
+        pushColors(x, y, width, height, data);
+        return false;
+    }
+    virtual bool pushDone()
+    {
+        return true;
+    }
+    // Wire time of the last finished queued push, in microseconds
+    virtual uint32_t lastPushUs()
+    {
+        return 0;
+    }
+
 protected:
     uint16_t _offset_x = 0;
     uint16_t _offset_y = 0;
@@ -0,0 +1,40 @@
+/**
+ * @file      RotateBlit.h
+ * @license   MIT
+ *
+ * The quarter-turn copy behind LilyGo_AMOLED::pushColors(x, y, w, h, data).
+ * Kept free of any board dependency so host builds can time it too.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Rotates a width x hight area 90 degrees clockwise into dst, so that
+ * dst[j * hight + i] = src[width * (hight - i - 1) + j]. Walking the area in
+ * ROTATE_TILE square tiles keeps the working set to ROTATE_TILE source
+ * lines and ROTATE_TILE destination runs, instead of striding a full
+ * column of the source for every output row.
+ */
+#define ROTATE_TILE             (16)
+
+static inline void rotateBlit(uint16_t *dst, const uint16_t *src, uint16_t width, uint16_t hight)
+{
+    for (uint16_t r0 = 0; r0 < hight; r0 += ROTATE_TILE) {
+        uint16_t rows = (hight - r0 < ROTATE_TILE) ? (uint16_t)(hight - r0) : (uint16_t)ROTATE_TILE;
+
+        for (uint16_t c0 = 0; c0 < width; c0 += ROTATE_TILE) {
+            uint16_t cols = (width - c0 < ROTATE_TILE) ? (uint16_t)(width - c0) : (uint16_t)ROTATE_TILE;
+
+            for (uint16_t c = 0; c < cols; c++) {
+                // Source column c0 + c, top to bottom, lands right to left
+                const uint16_t *s = src + (uint32_t)r0 * width + c0 + c;
+                uint16_t *d = dst + (uint32_t)(c0 + c) * hight + (hight - 1 - r0);
+                for (uint16_t r = 0; r < rows; r++) {
+                    *d-- = *s;
+                    s += width;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,389 @@
+// Timings for the update path stages, run on the host against the same
+// sources as the device. Each stage reports the median and p90 time per
+// operation over a number of samples; results are written as JSON, and a
+// stage whose median grows past the stored baseline by more than the
+// tolerance fails the run.
+//
+//   pio run -e bench && .pio/build/bench/program --save-baseline
+//   .pio/build/bench/program --out bench.json   # exit 1 on a regression
+//
+// Host numbers are only comparable with a baseline saved on the same
+// machine; they guard the relative cost of each stage, not device timings.
+
+#include "RotateBlit.h"
+#include "candle_export.h"
+#include "candle_store.h"
+#include "chart_stream_parser.h"
+#include "config.h"
+#include "data_fetcher.h"
+#include "enhanced_candle_stick.h"
+#include "sim_display.h"
+#include "ui.h"
+#include <ArduinoJson.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#define BENCH_SAMPLES 21
+#define BENCH_SAMPLE_NS 20000000ULL // Operations per sample fill about 20 ms
+#define BENCH_TOLERANCE 0.25f
+#define BENCH_BASELINE "native/bench_baseline.json"
+#define BENCH_TCP_SEGMENT 1436 // Ingest feeds the parser one segment a time
+
+typedef struct {
+  std::string stage;
+  uint32_t ops_per_sample;
+  double median_ns;
+  double p90_ns;
+} bench_result_t;
+
+static std::vector<bench_result_t> results;
+
+static uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Times `op` per call. Each sample runs about BENCH_SAMPLE_NS worth of
+// calls, which keeps fast stages above timer noise. The batch is sized
+// from a doubling run after a warm-up call, since a single cold call can
+// take many times the steady cost and would undersize it.
+template <typename Op> static void bench(const std::string &stage, Op op) {
+  op();
+  uint64_t start, elapsed;
+  uint32_t ops = 1;
+  for (;;) {
+    start = nowNs();
+    for (uint32_t i = 0; i < ops; i++) {
+      op();
+    }
+    elapsed = std::max<uint64_t>(1, nowNs() - start);
+    if (elapsed >= BENCH_SAMPLE_NS / 16 || ops >= (1u << 30)) {
+      break;
+    }
+    ops *= 2;
+  }
+  ops = (uint32_t)std::max<uint64_t>(1, (uint64_t)ops * BENCH_SAMPLE_NS /
+                                            elapsed);
+
+  std::vector<double> per_op;
+  for (int sample = 0; sample < BENCH_SAMPLES; sample++) {
+    start = nowNs();
+    for (uint32_t i = 0; i < ops; i++) {
+      op();
+    }
+    per_op.push_back((double)(nowNs() - start) / ops);
+  }
+  std::sort(per_op.begin(), per_op.end());
+
+  bench_result_t result = {stage, ops, per_op[BENCH_SAMPLES / 2],
+                           per_op[BENCH_SAMPLES * 9 / 10]};
+  results.push_back(result);
+  fprintf(stderr, "%-28s %12.0f ns  p90 %12.0f ns  (%u ops/sample)\n",
+          stage.c_str(), result.median_ns, result.p90_ns, ops);
+}
+
+// ---- JSON ingest ----
+
+// A Yahoo v8 chart body for `bars` one-minute bars, laid out like the real
+// service's, with the occasional null bar it sends for quiet minutes
+static std::string chartBody(int bars) {
+  std::string timestamps, open, high, low, close, volume;
+  time_t start = 1700000000;
+  float price = 250.0f;
+  char value[32];
+  for (int i = 0; i < bars; i++) {
+    const char *sep = (i == 0) ? "" : ",";
+    snprintf(value, sizeof(value), "%s%ld", sep, (long)(start + i * 60));
+    timestamps += value;
+    if (i % 97 == 96) {
+      open += std::string(sep) + "null";
+      high += std::string(sep) + "null";
+      low += std::string(sep) + "null";
+      close += std::string(sep) + "null";
+      volume += std::string(sep) + "null";
+      continue;
+    }
+    float next = price * (1.0f + (float)((i * 7919) % 201 - 100) / 20000.0f);
+    float wick = 0.05f;
+    snprintf(value, sizeof(value), "%s%.6f", sep, price);
+    open += value;
+    snprintf(value, sizeof(value), "%s%.6f", sep, std::max(price, next) + wick);
+    high += value;
+    snprintf(value, sizeof(value), "%s%.6f", sep, std::min(price, next) - wick);
+    low += value;
+    snprintf(value, sizeof(value), "%s%.6f", sep, next);
+    close += value;
+    snprintf(value, sizeof(value), "%s%d", sep, 1000 + (i * 31) % 9000);
+    volume += value;
+    price = next;
+  }
+  return "{\"chart\":{\"result\":[{\"meta\":{\"currency\":\"USD\",\"symbol\":"
+         "\"SPY\",\"dataGranularity\":\"1m\"},\"timestamp\":[" +
+         timestamps + "],\"indicators\":{\"quote\":[{\"open\":[" + open +
+         "],\"high\":[" + high + "],\"low\":[" + low + "],\"close\":[" +
+         close + "],\"volume\":[" + volume + "]}]}}],\"error\":null}}";
+}
+
+static std::vector<enhanced_candle_t> ingest_rows;
+
+static void ingestValue(ChartField field, uint32_t index, double value,
+                        void *ctx) {
+  if (index >= ingest_rows.size()) {
+    return;
+  }
+  enhanced_candle_t &row = ingest_rows[index];
+  switch (field) {
+  case CHART_FIELD_TIMESTAMP:
+    row.timestamp = (time_t)value;
+    break;
+  case CHART_FIELD_OPEN:
+    row.open = value;
+    break;
+  case CHART_FIELD_HIGH:
+    row.high = value;
+    break;
+  case CHART_FIELD_LOW:
+    row.low = value;
+    break;
+  case CHART_FIELD_CLOSE:
+    row.close = value;
+    break;
+  default:
+    row.volume = (uint32_t)value;
+    break;
+  }
+}
+
+// Body bytes through the streaming parser into a CandleStore, the way an
+// initial load goes from the socket to the chart
+static void benchIngest(int bars) {
+  std::string body = chartBody(bars);
+  CandleStore store;
+  store.allocate(bars);
+  ingest_rows.assign(bars, enhanced_candle_t());
+
+  bench("ingest_" + std::to_string(bars), [&]() {
+    ChartStreamParser parser(ingestValue, NULL);
+    for (size_t at = 0; at < body.size(); at += BENCH_TCP_SEGMENT) {
+      parser.feed(body.data() + at,
+                  std::min((size_t)BENCH_TCP_SEGMENT, body.size() - at));
+    }
+    store.clear();
+    for (uint32_t i = 0; i < parser.getRowCount(); i++) {
+      enhanced_candle_t &row = ingest_rows[i];
+      row.is_complete = true;
+      if (row.close > 0) {
+        store.push(row);
+      }
+    }
+  });
+}
+
+// ---- Update path ----
+
+static void benchUpdatePath() {
+  USE_TEST_DATA = true;
+  INTRADAY_UPDATE_INTERVAL = 0;
+  TEST_DATA_UPDATES_PER_BAR = 10;
+  DataFetcher::initialize(STOCK_SYMBOL);
+
+  // One test tick: a price through buildIntradayCandle into the store
+  bench("test_tick", []() { DataFetcher::updateData(); });
+
+  // Fill the store so visible-range queries see a full history
+  TEST_DATA_UPDATES_PER_BAR = 1;
+  while (DataFetcher::getCandleCount() < DataFetcher::getStore().capacity()) {
+    DataFetcher::updateData();
+  }
+
+  const int visible[] = {50, 456, DataFetcher::getCandleCount()};
+  for (int bars : visible) {
+    bench("price_levels_" + std::to_string(bars), [bars]() {
+      float low, high;
+      DataFetcher::getPriceLevelsForVisibleBars(&low, &high, bars);
+    });
+  }
+}
+
+// ---- Export ----
+
+static void appendExport(const uint8_t *data, size_t len, void *ctx) {
+  std::vector<uint8_t> *out = (std::vector<uint8_t> *)ctx;
+  out->insert(out->end(), data, data + len);
+}
+
+// /candles.bin from a wrapped ring into memory, so the stage times the
+// encoder and not a socket
+static void benchExport(int bars) {
+  CandleStore store;
+  store.allocate(bars);
+  for (int i = 0; i < bars + bars / 2; i++) {
+    enhanced_candle_t candle = {250.0f, 250.5f, 251.0f, 249.5f, 1000,
+                                (time_t)(1700000000 + i * 60), true};
+    store.push(candle);
+  }
+
+  std::vector<uint8_t> image;
+  image.reserve(CandleExport::encodedSize(bars));
+  std::string stage = "export_" + std::to_string(bars);
+  bench(stage, [&]() {
+    image.clear();
+    CandleExport::write(store, "SPY", "1m", bars, appendExport, &image);
+  });
+  fprintf(stderr, "%-28s %12.0f MB/s\n", stage.c_str(),
+          image.size() / results.back().median_ns * 1000.0);
+}
+
+// ---- Render ----
+
+// Chart rebuild plus the LVGL refresh that puts it on the panel
+static void benchRender() {
+  const int bars_to_show[] = {50, 200, 456};
+  for (int canvas = 0; canvas < 2; canvas++) {
+    USE_CANVAS_RENDERER = canvas;
+    for (int bars : bars_to_show) {
+      BARS_TO_SHOW = bars;
+      bench(std::string(canvas ? "render_canvas_" : "render_objects_") +
+                std::to_string(bars),
+            []() {
+              EnhancedCandleStick::create(ui_chart, STOCK_SYMBOL);
+              lv_refr_now(NULL);
+            });
+    }
+  }
+  USE_CANVAS_RENDERER = false;
+}
+
+// ---- Panel rotate ----
+
+static void benchRotate() {
+  std::vector<uint16_t> src(SIM_HOR_RES * SIM_VER_RES);
+  std::vector<uint16_t> dst(src.size());
+  for (size_t i = 0; i < src.size(); i++) {
+    src[i] = (uint16_t)(i * 2654435761u >> 16);
+  }
+  bench("rotate_strip", [&]() {
+    rotateBlit(dst.data(), src.data(), SIM_HOR_RES, SIM_BUF_LINES);
+  });
+  bench("rotate_frame", [&]() {
+    rotateBlit(dst.data(), src.data(), SIM_HOR_RES, SIM_VER_RES);
+  });
+}
+
+// ---- Results ----
+
+static bool writeResults(const char *path) {
+  JsonDocument doc;
+  JsonArray stages = doc["stages"].to<JsonArray>();
+  for (const bench_result_t &result : results) {
+    JsonObject stage = stages.add<JsonObject>();
+    stage["stage"] = result.stage.c_str();
+    stage["median_ns"] = (uint64_t)result.median_ns;
+    stage["p90_ns"] = (uint64_t)result.p90_ns;
+    stage["ops_per_sample"] = result.ops_per_sample;
+  }
+
+  std::string json;
+  serializeJsonPretty(doc, json);
+  FILE *file = fopen(path, "w");
+  if (file == NULL) {
+    return false;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  return true;
+}
+
+// Number of stages slower than baseline * (1 + tolerance), or -1 when
+// there is no baseline to compare against
+static int compareBaseline(const char *path, float tolerance) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    return -1;
+  }
+  std::string json;
+  char chunk[1024];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    json.append(chunk, n);
+  }
+  fclose(file);
+
+  JsonDocument doc;
+  if (deserializeJson(doc, json)) {
+    return -1;
+  }
+
+  int regressions = 0;
+  for (const bench_result_t &result : results) {
+    double baseline = 0;
+    for (JsonVariant stage : doc["stages"].as<JsonArray>()) {
+      if (stage["stage"] == result.stage.c_str()) {
+        baseline = stage["median_ns"].as<double>();
+      }
+    }
+    if (baseline <= 0) {
+      fprintf(stderr, "%-28s new stage, no baseline\n", result.stage.c_str());
+      continue;
+    }
+    double change = result.median_ns / baseline - 1.0;
+    bool regressed = change > tolerance;
+    regressions += regressed;
+    fprintf(stderr, "%-28s %+6.1f%% vs baseline%s\n", result.stage.c_str(),
+            change * 100.0, regressed ? "  REGRESSED" : "");
+  }
+  return regressions;
+}
+
+int main(int argc, char **argv) {
+  const char *out_path = "bench.json";
+  const char *baseline_path = BENCH_BASELINE;
+  float tolerance = BENCH_TOLERANCE;
+  bool save_baseline = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      out_path = argv[++i];
+    } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      baseline_path = argv[++i];
+    } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+      tolerance = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--save-baseline") == 0) {
+      save_baseline = true;
+    }
+  }
+
+  beginSimDisplay();
+  ui_init();
+  loadConfig();
+  randomSeed(1); // Same test series every run
+
+  benchIngest(390);  // 1d of 1m bars
+  benchIngest(1950); // 5d
+  benchIngest(7800); // About a month
+  benchUpdatePath();
+  benchExport(7800);
+  benchRender();
+  benchRotate();
+
+  if (!writeResults(save_baseline ? baseline_path : out_path)) {
+    fprintf(stderr, "Could not write results\n");
+    return 2;
+  }
+  if (save_baseline) {
+    fprintf(stderr, "Baseline saved to %s\n", baseline_path);
+    return 0;
+  }
+
+  int regressions = compareBaseline(baseline_path, tolerance);
+  if (regressions < 0) {
+    fprintf(stderr, "No baseline at %s; run with --save-baseline first\n",
+            baseline_path);
+    return 0;
+  }
+  fprintf(stderr, "%d stage(s) regressed more than %.0f%%\n", regressions,
+          tolerance * 100.0f);
+  return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,360 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Just enough of the Arduino-ESP32 core for the ticker sources to build and
+// run on a Linux host. Timing comes from the host's monotonic clock; output
+// goes to stdout.
+
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+extern "C" {
+#endif
+
+unsigned long millis(void);
+unsigned long micros(void);
+uint32_t getCpuFrequencyMhz(void); // Host cycles are nanoseconds
+void delay(unsigned long ms);
+void yield(void);
+
+#define ps_malloc malloc
+#define ps_calloc calloc
+#define ps_realloc realloc
+
+#ifdef __cplusplus
+}
+
+// glibc only gained strlcpy in 2.38
+inline size_t native_strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size > 0) {
+    size_t n = std::min(len, size - 1);
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+#define strlcpy native_strlcpy
+
+#define constrain(amt, low, high)                                              \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+typedef void *TaskHandle_t;
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+#define pdPASS 1
+#define pdFAIL 0
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+// Tasks become detached host threads; core, stack and priority are ignored
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void *), const char *name,
+                                   uint32_t stack, void *arg, int priority,
+                                   TaskHandle_t *handle, int core);
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
+
+// Critical sections are a spin lock, as on the dual-core target
+typedef struct {
+  std::atomic_flag flag;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {ATOMIC_FLAG_INIT}
+#define portENTER_CRITICAL(mux)                                                \
+  while ((mux)->flag.test_and_set(std::memory_order_acquire)) {                \
+  }
+#define portEXIT_CRITICAL(mux) (mux)->flag.clear(std::memory_order_release)
+
+class String {
+private:
+  std::string s;
+
+public:
+  String(const char *str = "") : s(str ? str : "") {}
+  String(const std::string &str) : s(str) {}
+  String(char c) : s(1, c) {}
+  String(int value) : s(std::to_string(value)) {}
+  String(unsigned int value) : s(std::to_string(value)) {}
+  String(long value) : s(std::to_string(value)) {}
+  String(unsigned long value) : s(std::to_string(value)) {}
+  String(long long value) : s(std::to_string(value)) {}
+  String(unsigned long long value) : s(std::to_string(value)) {}
+  String(double value, unsigned int decimals = 2) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    s = buf;
+  }
+  String(float value, unsigned int decimals = 2)
+      : String((double)value, decimals) {}
+  String(bool value) : s(value ? "1" : "0") {}
+
+  const char *c_str() const { return s.c_str(); }
+  unsigned int length() const { return s.length(); }
+  bool isEmpty() const { return s.empty(); }
+  void reserve(unsigned int size) { s.reserve(size); }
+  char charAt(unsigned int i) const { return i < s.size() ? s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  char &operator[](unsigned int i) { return s[i]; }
+
+  bool concat(const String &str) { s += str.s; return true; }
+  bool concat(const char *str) { s += str; return true; }
+  bool concat(const char *str, unsigned int len) {
+    s.append(str, len);
+    return true;
+  }
+  bool concat(char c) { s += c; return true; }
+  String &operator+=(const String &str) { s += str.s; return *this; }
+  String &operator+=(const char *str) { s += str; return *this; }
+  String &operator+=(char c) { s += c; return *this; }
+
+  friend String operator+(const String &a, const String &b) {
+    return String(a.s + b.s);
+  }
+  friend String operator+(const String &a, const char *b) {
+    return String(a.s + b);
+  }
+  friend String operator+(const char *a, const String &b) {
+    return String(a + b.s);
+  }
+  friend String operator+(const String &a, char b) { return String(a.s + b); }
+
+  bool operator==(const String &o) const { return s == o.s; }
+  bool operator==(const char *o) const { return s == o; }
+  bool operator!=(const String &o) const { return s != o.s; }
+  bool operator!=(const char *o) const { return s != o; }
+  bool operator<(const String &o) const { return s < o.s; }
+  bool equals(const String &o) const { return s == o.s; }
+  bool equalsIgnoreCase(const String &o) const {
+    return strcasecmp(s.c_str(), o.s.c_str()) == 0;
+  }
+  bool startsWith(const String &prefix) const {
+    return s.compare(0, prefix.s.size(), prefix.s) == 0;
+  }
+  bool endsWith(const String &suffix) const {
+    return s.size() >= suffix.s.size() &&
+           s.compare(s.size() - suffix.s.size(), suffix.s.size(),
+                     suffix.s) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t i = s.find(c, from);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  int indexOf(const String &str, unsigned int from = 0) const {
+    size_t i = s.find(str.s, from);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  int lastIndexOf(char c) const {
+    size_t i = s.rfind(c);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  String substring(unsigned int from) const {
+    return from < s.size() ? String(s.substr(from)) : String();
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+      std::swap(from, to);
+    }
+    if (from >= s.size()) {
+      return String();
+    }
+    return String(s.substr(from, to - from));
+  }
+
+  void trim() {
+    size_t start = s.find_first_not_of(" \t\r\n");
+    size_t end = s.find_last_not_of(" \t\r\n");
+    s = (start == std::string::npos) ? "" : s.substr(start, end - start + 1);
+  }
+  void toUpperCase() {
+    for (char &c : s) {
+      c = toupper((unsigned char)c);
+    }
+  }
+  void toLowerCase() {
+    for (char &c : s) {
+      c = tolower((unsigned char)c);
+    }
+  }
+  void replace(const String &from, const String &to) {
+    if (from.s.empty()) {
+      return;
+    }
+    for (size_t i = s.find(from.s); i != std::string::npos;
+         i = s.find(from.s, i + to.s.size())) {
+      s.replace(i, from.s.size(), to.s);
+    }
+  }
+  void remove(unsigned int index, unsigned int count = (unsigned int)-1) {
+    if (index < s.size()) {
+      s.erase(index, count);
+    }
+  }
+
+  long toInt() const { return strtol(s.c_str(), NULL, 10); }
+  float toFloat() const { return strtof(s.c_str(), NULL); }
+  double toDouble() const { return strtod(s.c_str(), NULL); }
+};
+
+// ArduinoJson's String adapter also names the core's concatenation helper
+class StringSumHelper : public String {
+public:
+  using String::String;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t size) {
+    size_t n = 0;
+    while (size--) {
+      n += write(*buf++);
+    }
+    return n;
+  }
+  size_t write(const char *str) {
+    return write((const uint8_t *)str, strlen(str));
+  }
+  size_t write(const char *buf, size_t size) {
+    return write((const uint8_t *)buf, size);
+  }
+
+  size_t print(const String &str) { return write(str.c_str()); }
+  size_t print(const char *str) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int value) { return print(String(value)); }
+  size_t print(unsigned int value) { return print(String(value)); }
+  size_t print(long value) { return print(String(value)); }
+  size_t print(unsigned long value) { return print(String(value)); }
+  size_t print(double value, int decimals = 2) {
+    return print(String(value, decimals));
+  }
+  template <typename T> size_t println(const T &value) {
+    return print(value) + write("\r\n");
+  }
+  size_t println() { return write("\r\n"); }
+
+  size_t printf(const char *format, ...)
+      __attribute__((format(printf, 2, 3))) {
+    char buf[512];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) {
+      return 0;
+    }
+    return write((const uint8_t *)buf, std::min((size_t)len, sizeof(buf) - 1));
+  }
+};
+
+class Stream : public Print {
+protected:
+  unsigned long _timeout = 1000;
+
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual void flush() {}
+
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+  unsigned long getTimeout() const { return _timeout; }
+
+  size_t readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    unsigned long start = millis();
+    while (count < length && millis() - start < _timeout) {
+      int c = read();
+      if (c < 0) {
+        if (available() <= 0) {
+          break;
+        }
+        continue;
+      }
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+  size_t readBytes(uint8_t *buffer, size_t length) {
+    return readBytes((char *)buffer, length);
+  }
+};
+
+// Serial goes to stdout, with the device's CRLF line endings normalised
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override {
+    if (c != '\r') {
+      fputc(c, stdout);
+    }
+    return 1;
+  }
+  size_t write(const uint8_t *buf, size_t size) override {
+    for (size_t i = 0; i < size; i++) {
+      write(buf[i]);
+    }
+    return size;
+  }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+class IPAddress {
+private:
+  uint8_t octets[4];
+
+public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0)
+      : octets{a, b, c, d} {}
+  bool fromString(const String &str) {
+    unsigned a, b, c, d;
+    if (sscanf(str.c_str(), "%u.%u.%u.%u", &a, &b, &c, &d) != 4) {
+      return false;
+    }
+    *this = IPAddress(a, b, c, d);
+    return true;
+  }
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", octets[0], octets[1],
+             octets[2], octets[3]);
+    return String(buf);
+  }
+};
+
+// Host memory is not tracked; the heap figures only keep the logging and
+// /metrics code building
+class EspClass {
+public:
+  uint32_t getHeapSize() { return 0; }
+  uint32_t getFreeHeap() { return 0; }
+  uint32_t getMinFreeHeap() { return 0; }
+  uint32_t getMaxAllocHeap() { return 0; }
+  uint32_t getFreePsram() { return 0; }
+  uint32_t getMinFreePsram() { return 0; }
+  uint32_t getPsramSize() { return 0; }
+  uint32_t getCycleCount();
+  void restart() { exit(0); }
+};
+extern EspClass ESP;
+
+#endif // __cplusplus
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,40 @@
+#ifndef NATIVE_HTTP_CLIENT_H
+#define NATIVE_HTTP_CLIENT_H
+
+#include "WiFiClient.h"
+#include <map>
+
+#define HTTP_CODE_OK 200
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+// GET-only HTTP/1.1 client over a caller-owned connection, covering what
+// HttpSession uses: keep-alive reuse, Content-Length and collected headers.
+// The body is left on the client for the caller to read.
+class HTTPClient {
+private:
+  WiFiClient *client = NULL;
+  String host;
+  uint16_t port = 80;
+  String path;
+  bool reuse = true;
+  unsigned long timeout = 5000;
+  int size = -1;
+  std::map<std::string, String> wanted; // Lower-cased name -> value
+
+  bool readLine(String &line);
+
+public:
+  bool begin(WiFiClient &client, const String &url);
+  void setReuse(bool reuse) { this->reuse = reuse; }
+  void setTimeout(unsigned long timeout) { this->timeout = timeout; }
+  void collectHeaders(const char *names[], size_t count);
+  int GET();
+  int getSize() const { return size; }
+  String header(const char *name);
+  void end();
+};
+
+#endif // NATIVE_HTTP_CLIENT_H
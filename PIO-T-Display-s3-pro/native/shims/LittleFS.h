@@ -0,0 +1,30 @@
+#ifndef NATIVE_LITTLEFS_H
+#define NATIVE_LITTLEFS_H
+
+#include "Arduino.h"
+
+// Host runs have no flash partition: mounting fails, so snapshots stay off
+class File {
+public:
+  operator bool() const { return false; }
+  size_t size() { return 0; }
+  size_t read(uint8_t *, size_t) { return 0; }
+  size_t write(const uint8_t *, size_t) { return 0; }
+  void close() {}
+  String path() const { return ""; }
+  File openNextFile() { return File(); }
+};
+
+class LittleFSFS {
+public:
+  bool begin(bool format_on_fail = false) { return false; }
+  size_t totalBytes() { return 0; }
+  size_t usedBytes() { return 0; }
+  bool exists(const String &) { return false; }
+  File open(const String &, const char * = "r") { return File(); }
+  bool remove(const String &) { return false; }
+  bool rename(const String &, const String &) { return false; }
+};
+extern LittleFSFS LittleFS;
+
+#endif // NATIVE_LITTLEFS_H
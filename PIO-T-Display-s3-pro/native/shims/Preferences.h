@@ -0,0 +1,29 @@
+#ifndef NATIVE_PREFERENCES_H
+#define NATIVE_PREFERENCES_H
+
+#include "Arduino.h"
+
+// Namespaced key/value store kept in memory for the life of the process
+class Preferences {
+private:
+  std::string ns;
+  bool writable = false;
+
+  const String *find(const char *key) const;
+  size_t put(const char *key, const String &value);
+
+public:
+  bool begin(const char *name, bool read_only = false);
+  void end() {}
+
+  bool getBool(const char *key, bool default_value = false) const;
+  int32_t getInt(const char *key, int32_t default_value = 0) const;
+  String getString(const char *key, const String &default_value = "") const;
+
+  size_t putBool(const char *key, bool value);
+  size_t putInt(const char *key, int32_t value);
+  size_t putString(const char *key, const String &value);
+  bool remove(const char *key);
+};
+
+#endif // NATIVE_PREFERENCES_H
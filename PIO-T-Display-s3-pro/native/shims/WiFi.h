@@ -0,0 +1,16 @@
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+#include "WiFiClient.h"
+
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+
+// The host's own network stack is always up
+class WiFiClass {
+public:
+  wl_status_t status() { return WL_CONNECTED; }
+  IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+};
+extern WiFiClass WiFi;
+
+#endif // NATIVE_WIFI_H
@@ -0,0 +1,40 @@
+#ifndef NATIVE_WIFI_CLIENT_H
+#define NATIVE_WIFI_CLIENT_H
+
+#include "Client.h"
+#include <memory>
+
+// Plain TCP over host sockets, so the fetch code can talk to a local
+// stand-in server. Copies share the socket, as on the device.
+class WiFiClient : public Client {
+private:
+  std::shared_ptr<int> sock;
+  int peeked = -1;
+
+  bool fill(bool wait);
+  void adopt(int fd);
+
+public:
+  WiFiClient() {}
+  // Takes over a connected socket, as the device's WiFiServer does
+  explicit WiFiClient(int fd) { adopt(fd); }
+
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char *host, uint16_t port) override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t *buf, size_t size) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return connected(); }
+
+  int fd() const { return sock ? *sock : -1; }
+  void setNoDelay(bool) {}
+  IPAddress remoteIP() const { return IPAddress(127, 0, 0, 1); }
+};
+
+#endif // NATIVE_WIFI_CLIENT_H
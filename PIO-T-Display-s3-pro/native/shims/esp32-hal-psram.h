@@ -0,0 +1,7 @@
+#ifndef NATIVE_ESP32_HAL_PSRAM_H
+#define NATIVE_ESP32_HAL_PSRAM_H
+
+// lv_conf.h takes LVGL's allocator from here; the host heap stands in
+#include "Arduino.h"
+
+#endif // NATIVE_ESP32_HAL_PSRAM_H
@@ -0,0 +1,20 @@
+#ifndef NATIVE_ESP_ROM_CRC_H
+#define NATIVE_ESP_ROM_CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bitwise stand-in for the ROM routine; same polynomial and chaining
+static inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf,
+                                        size_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *buf++;
+    for (int k = 0; k < 8; k++) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+#endif // NATIVE_ESP_ROM_CRC_H
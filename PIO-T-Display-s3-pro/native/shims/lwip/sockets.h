@@ -0,0 +1,9 @@
+#ifndef NATIVE_LWIP_SOCKETS_H
+#define NATIVE_LWIP_SOCKETS_H
+
+// lwIP's BSD socket API is the host's own
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#endif // NATIVE_LWIP_SOCKETS_H
@@ -0,0 +1,438 @@
+#include "Arduino.h"
+#include "HTTPClient.h"
+#include "LittleFS.h"
+#include "Preferences.h"
+#include "WiFi.h"
+#include "nvs.h"
+#include <chrono>
+#include <errno.h>
+#include <map>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+LittleFSFS LittleFS;
+
+// ---- Time and randomness ----
+
+static const auto process_start = std::chrono::steady_clock::now();
+
+unsigned long millis(void) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - process_start)
+      .count();
+}
+
+unsigned long micros(void) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - process_start)
+      .count();
+}
+
+uint32_t getCpuFrequencyMhz(void) { return 1000; }
+
+uint32_t EspClass::getCycleCount() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - process_start)
+      .count();
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield(void) { std::this_thread::yield(); }
+
+long random(long max) { return (max > 0) ? ::random() % max : 0; }
+
+long random(long min, long max) {
+  return (max > min) ? min + random(max - min) : min;
+}
+
+void randomSeed(unsigned long seed) { srandom(seed); }
+
+// ---- Tasks ----
+
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void *), const char *,
+                                   uint32_t, void *arg, int,
+                                   TaskHandle_t *handle, int) {
+  std::thread *thread = new std::thread(task, arg); // Runs until exit
+  thread->detach();
+  if (handle != NULL) {
+    *handle = thread;
+  }
+  return pdPASS;
+}
+
+// ---- Preferences and NVS share one table ----
+
+static std::map<std::string, String> &nvsTable() {
+  static std::map<std::string, String> table;
+  return table;
+}
+
+static std::map<nvs_handle_t, std::string> nvs_handles;
+static native_nvs_stats_t nvs_stats = {0, 0};
+
+bool Preferences::begin(const char *name, bool read_only) {
+  ns = name;
+  writable = !read_only;
+  return true;
+}
+
+const String *Preferences::find(const char *key) const {
+  auto it = nvsTable().find(ns + "/" + key);
+  return (it == nvsTable().end()) ? NULL : &it->second;
+}
+
+size_t Preferences::put(const char *key, const String &value) {
+  if (!writable) {
+    return 0;
+  }
+  nvsTable()[ns + "/" + key] = value;
+  nvs_stats.writes++;
+  nvs_stats.commits++; // Preferences commits every put
+  return value.length();
+}
+
+bool Preferences::getBool(const char *key, bool default_value) const {
+  const String *value = find(key);
+  return value ? value->toInt() != 0 : default_value;
+}
+
+int32_t Preferences::getInt(const char *key, int32_t default_value) const {
+  const String *value = find(key);
+  return value ? value->toInt() : default_value;
+}
+
+String Preferences::getString(const char *key,
+                              const String &default_value) const {
+  const String *value = find(key);
+  return value ? *value : default_value;
+}
+
+size_t Preferences::putBool(const char *key, bool value) {
+  return put(key, value ? "1" : "0");
+}
+
+size_t Preferences::putInt(const char *key, int32_t value) {
+  return put(key, String((long)value));
+}
+
+size_t Preferences::putString(const char *key, const String &value) {
+  return put(key, value);
+}
+
+bool Preferences::remove(const char *key) {
+  return writable && nvsTable().erase(ns + "/" + key) > 0;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t, nvs_handle_t *handle) {
+  static nvs_handle_t next = 1;
+  *handle = next++;
+  nvs_handles[*handle] = name;
+  return ESP_OK;
+}
+
+static esp_err_t nvsSet(nvs_handle_t handle, const char *key,
+                        const String &value) {
+  auto it = nvs_handles.find(handle);
+  if (it == nvs_handles.end()) {
+    return ESP_FAIL;
+  }
+  nvsTable()[it->second + "/" + key] = value;
+  nvs_stats.writes++;
+  return ESP_OK;
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value) {
+  return nvsSet(handle, key, String((unsigned)value));
+}
+
+esp_err_t nvs_set_i32(nvs_handle_t handle, const char *key, int32_t value) {
+  return nvsSet(handle, key, String((long)value));
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key,
+                      const char *value) {
+  return nvsSet(handle, key, value);
+}
+
+esp_err_t nvs_commit(nvs_handle_t) {
+  nvs_stats.commits++;
+  return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) { nvs_handles.erase(handle); }
+
+const char *esp_err_to_name(esp_err_t err) {
+  return (err == ESP_OK) ? "ESP_OK" : "ESP_FAIL";
+}
+
+const native_nvs_stats_t &nativeNvsStats() { return nvs_stats; }
+
+// ---- TCP ----
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+  return connect(ip.toString().c_str(), port);
+}
+
+int WiFiClient::connect(const char *host, uint16_t port) {
+  stop();
+
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo *found = NULL;
+  if (getaddrinfo(host, String((unsigned)port).c_str(), &hints, &found) != 0) {
+    return 0;
+  }
+
+  int fd = -1;
+  for (struct addrinfo *ai = found; ai != NULL && fd < 0; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd >= 0 && ::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(found);
+  if (fd < 0) {
+    return 0;
+  }
+
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  adopt(fd);
+  return 1;
+}
+
+void WiFiClient::adopt(int fd) {
+  sock = std::shared_ptr<int>(new int(fd), [](int *p) {
+    close(*p);
+    delete p;
+  });
+  peeked = -1;
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t size) {
+  size_t sent = 0;
+  while (sock && sent < size) {
+    ssize_t n = send(*sock, buf + sent, size - sent, MSG_NOSIGNAL);
+    if (n <= 0) {
+      stop();
+      break;
+    }
+    sent += n;
+  }
+  return sent;
+}
+
+bool WiFiClient::fill(bool wait) {
+  if (peeked >= 0) {
+    return true;
+  }
+  if (!sock) {
+    return false;
+  }
+  uint8_t c;
+  ssize_t n = recv(*sock, &c, 1, wait ? 0 : MSG_DONTWAIT);
+  if (n == 1) {
+    peeked = c;
+    return true;
+  }
+  if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+    stop(); // Closed by the peer
+  }
+  return false;
+}
+
+int WiFiClient::available() {
+  if (!sock) {
+    return (peeked >= 0) ? 1 : 0;
+  }
+  int pending = 0;
+  ioctl(*sock, FIONREAD, &pending);
+  if (pending == 0 && peeked < 0) {
+    fill(false); // Notices a peer close
+  }
+  return pending + (peeked >= 0 ? 1 : 0);
+}
+
+int WiFiClient::read() {
+  if (!fill(false)) {
+    return -1;
+  }
+  int c = peeked;
+  peeked = -1;
+  return c;
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size) {
+  if (size == 0) {
+    return 0;
+  }
+  size_t n = 0;
+  if (peeked >= 0) {
+    buf[n++] = peeked;
+    peeked = -1;
+  }
+  if (sock && n < size) {
+    ssize_t got = recv(*sock, buf + n, size - n, MSG_DONTWAIT);
+    if (got > 0) {
+      n += got;
+    } else if (got == 0) {
+      stop();
+    }
+  }
+  return (n > 0) ? (int)n : -1;
+}
+
+int WiFiClient::peek() { return fill(false) ? peeked : -1; }
+
+void WiFiClient::stop() {
+  sock.reset();
+  peeked = -1;
+}
+
+uint8_t WiFiClient::connected() {
+  if (peeked >= 0) {
+    return 1;
+  }
+  if (!sock) {
+    return 0;
+  }
+  available();
+  return sock ? 1 : 0;
+}
+
+// ---- HTTP ----
+
+bool HTTPClient::begin(WiFiClient &client, const String &url) {
+  int scheme_end = url.indexOf("://");
+  if (scheme_end < 0) {
+    return false;
+  }
+  String scheme = url.substring(0, scheme_end);
+  int host_start = scheme_end + 3;
+  int path_start = url.indexOf('/', host_start);
+  if (path_start < 0) {
+    path_start = url.length();
+  }
+  String authority = url.substring(host_start, path_start);
+  path = (path_start < (int)url.length()) ? url.substring(path_start) : "/";
+
+  int colon = authority.indexOf(':');
+  if (colon >= 0) {
+    host = authority.substring(0, colon);
+    port = authority.substring(colon + 1).toInt();
+  } else {
+    host = authority;
+    port = (scheme == "https") ? 443 : 80;
+  }
+
+  this->client = &client;
+  size = -1;
+  return true;
+}
+
+void HTTPClient::collectHeaders(const char *names[], size_t count) {
+  wanted.clear();
+  for (size_t i = 0; i < count; i++) {
+    String name = names[i];
+    name.toLowerCase();
+    wanted[name.c_str()] = "";
+  }
+}
+
+bool HTTPClient::readLine(String &line) {
+  line = "";
+  unsigned long start = millis();
+  while (millis() - start < timeout) {
+    int c = client->read();
+    if (c < 0) {
+      if (!client->connected()) {
+        return false;
+      }
+      delay(1);
+      continue;
+    }
+    if (c == '\n') {
+      return true;
+    }
+    if (c != '\r') {
+      line += (char)c;
+    }
+  }
+  return false;
+}
+
+int HTTPClient::GET() {
+  if (client == NULL) {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+  if (!client->connected() && !client->connect(host.c_str(), port)) {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+
+  String request = "GET " + path + " HTTP/1.1\r\nHost: " + host +
+                   "\r\nUser-Agent: ESP32HTTPClient\r\nConnection: " +
+                   (reuse ? "keep-alive" : "close") + "\r\n\r\n";
+  if (client->write((const uint8_t *)request.c_str(), request.length()) !=
+      request.length()) {
+    return HTTPC_ERROR_SEND_HEADER_FAILED;
+  }
+
+  String line;
+  if (!readLine(line)) {
+    return HTTPC_ERROR_READ_TIMEOUT;
+  }
+  int space = line.indexOf(' ');
+  int code = (space > 0) ? line.substring(space + 1).toInt() : 0;
+  if (code <= 0) {
+    return HTTPC_ERROR_CONNECTION_LOST;
+  }
+
+  for (auto &entry : wanted) {
+    entry.second = "";
+  }
+  while (readLine(line) && line.length() > 0) {
+    int colon = line.indexOf(':');
+    if (colon <= 0) {
+      continue;
+    }
+    String name = line.substring(0, colon);
+    String value = line.substring(colon + 1);
+    name.toLowerCase();
+    value.trim();
+    if (name == "content-length") {
+      size = value.toInt();
+    }
+    auto it = wanted.find(name.c_str());
+    if (it != wanted.end()) {
+      it->second = value;
+    }
+  }
+  return code;
+}
+
+String HTTPClient::header(const char *name) {
+  String key = name;
+  key.toLowerCase();
+  auto it = wanted.find(key.c_str());
+  return (it == wanted.end()) ? String() : it->second;
+}
+
+void HTTPClient::end() {
+  if (!reuse && client != NULL) {
+    client->stop();
+  }
+}
@@ -0,0 +1,33 @@
+#ifndef NATIVE_NVS_H
+#define NATIVE_NVS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// NVS over the same in-memory table as the Preferences shim, with write
+// and commit counters for flash-wear measurements
+typedef int esp_err_t;
+typedef uint32_t nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+#define ESP_OK 0
+#define ESP_FAIL (-1)
+#define ESP_ERR_NVS_NOT_FOUND 0x1102
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t mode,
+                   nvs_handle_t *handle);
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value);
+esp_err_t nvs_set_i32(nvs_handle_t handle, const char *key, int32_t value);
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key,
+                      const char *value);
+esp_err_t nvs_commit(nvs_handle_t handle);
+void nvs_close(nvs_handle_t handle);
+const char *esp_err_to_name(esp_err_t err);
+
+typedef struct {
+  uint32_t writes;
+  uint32_t commits;
+} native_nvs_stats_t;
+const native_nvs_stats_t &nativeNvsStats();
+
+#endif // NATIVE_NVS_H
@@ -0,0 +1,61 @@
+#include "sim_display.h"
+#include "time_helper.h"
+#include <stdio.h>
+#include <string.h>
+
+static lv_color_t framebuffer[SIM_HOR_RES * SIM_VER_RES];
+static lv_color_t draw_pixels[SIM_HOR_RES * SIM_BUF_LINES];
+static lv_disp_draw_buf_t draw_buf;
+static lv_disp_drv_t disp_drv;
+static uint64_t flushed_pixels = 0;
+
+// The host clock is already correct, so there is nothing to sync
+void initiateNTPTimeSync() {}
+bool isTimeSynchronized() { return true; }
+void updateTimeAndDate() {}
+
+static void flushToFramebuffer(lv_disp_drv_t *drv, const lv_area_t *area,
+                               lv_color_t *pixels) {
+  int width = lv_area_get_width(area);
+  for (int y = area->y1; y <= area->y2; y++) {
+    memcpy(&framebuffer[y * SIM_HOR_RES + area->x1], pixels,
+           width * sizeof(lv_color_t));
+    pixels += width;
+  }
+  flushed_pixels += (uint64_t)width * lv_area_get_height(area);
+  lv_disp_flush_ready(drv);
+}
+
+void beginSimDisplay() {
+  lv_init();
+  lv_disp_draw_buf_init(&draw_buf, draw_pixels, NULL,
+                        SIM_HOR_RES * SIM_BUF_LINES);
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = SIM_HOR_RES;
+  disp_drv.ver_res = SIM_VER_RES;
+  disp_drv.flush_cb = flushToFramebuffer;
+  disp_drv.draw_buf = &draw_buf;
+  lv_disp_drv_register(&disp_drv);
+}
+
+uint64_t simFlushedPixels() { return flushed_pixels; }
+
+bool writeSimPpm(const char *path) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    return false;
+  }
+  fprintf(file, "P6\n%d %d\n255\n", SIM_HOR_RES, SIM_VER_RES);
+  for (int i = 0; i < SIM_HOR_RES * SIM_VER_RES; i++) {
+    uint16_t rgb565 = framebuffer[i].full;
+#if LV_COLOR_16_SWAP
+    rgb565 = (rgb565 >> 8) | (rgb565 << 8); // Panel byte order
+#endif
+    uint8_t rgb[3] = {(uint8_t)(((rgb565 >> 11) & 0x1F) * 255 / 31),
+                      (uint8_t)(((rgb565 >> 5) & 0x3F) * 255 / 63),
+                      (uint8_t)((rgb565 & 0x1F) * 255 / 31)};
+    fwrite(rgb, 1, sizeof(rgb), file);
+  }
+  fclose(file);
+  return true;
+}
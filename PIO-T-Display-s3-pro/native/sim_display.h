@@ -0,0 +1,18 @@
+#ifndef SIM_DISPLAY_H
+#define SIM_DISPLAY_H
+
+#include <lvgl.h>
+#include <stdint.h>
+
+#define SIM_HOR_RES 536
+#define SIM_VER_RES 240
+#define SIM_BUF_LINES 40 // Same strip height class as the device buffers
+
+// A headless LVGL display: flushes land in an in-memory framebuffer, so the
+// host programs render exactly what the panel would get
+void beginSimDisplay();
+uint64_t simFlushedPixels();
+// Writes the framebuffer as a binary PPM; false if the file can't be opened
+bool writeSimPpm(const char *path);
+
+#endif // SIM_DISPLAY_H
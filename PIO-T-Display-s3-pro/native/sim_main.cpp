@@ -0,0 +1,228 @@
+// Headless host run of the ticker UI: the real chart, config and data code
+// render into an in-memory 536x240 framebuffer, so render and scaling
+// changes can be timed and compared without a flash cycle.
+//
+//   pio run -e native && .pio/build/native/program --frames 300 --ppm out.ppm
+//
+// With --url the real fetch path runs instead of test data, against a
+// plain-HTTP server such as tools/yahoo_standin.py, and the run reports how
+// quickly bars arrived and how long the chart lagged behind the clock:
+//
+//   .pio/build/native/program --url http://127.0.0.1:8765 --seconds 120
+
+#include "config.h"
+#include "data_fetcher.h"
+#include "enhanced_candle_stick.h"
+#include "fetch_task.h"
+#include "http_session.h"
+#include "sim_display.h"
+#include "ui.h"
+#include <algorithm>
+#include <time.h>
+#include <vector>
+
+#define SIM_FRAME_MS 33 // Replay runs pace the UI loop like the device
+
+static void printFrameStats(std::vector<uint32_t> &frame_us,
+                            uint64_t pixels) {
+  if (frame_us.empty()) {
+    return;
+  }
+  std::sort(frame_us.begin(), frame_us.end());
+  uint64_t total_us = 0;
+  for (uint32_t us : frame_us) {
+    total_us += us;
+  }
+  size_t frames = frame_us.size();
+  Serial.printf("Frame: avg %llu us, p50 %u us, p99 %u us, max %u us\n",
+                (unsigned long long)(total_us / frames), frame_us[frames / 2],
+                frame_us[frames * 99 / 100], frame_us.back());
+  Serial.printf("Flushed: %llu pixels per frame\n",
+                (unsigned long long)(pixels / frames));
+}
+
+static int runTestData(int frames) {
+  USE_TEST_DATA = true;
+  INTRADAY_UPDATE_INTERVAL = 0; // A test tick every frame
+
+  if (!DataFetcher::initialize(STOCK_SYMBOL)) {
+    Serial.println("DataFetcher failed to initialize");
+    return 1;
+  }
+  EnhancedCandleStick::create(ui_chart, STOCK_SYMBOL);
+  lv_refr_now(NULL);
+
+  std::vector<uint32_t> frame_us;
+  frame_us.reserve(frames);
+  uint64_t pixels_before = simFlushedPixels();
+
+  for (int frame = 0; frame < frames; frame++) {
+    unsigned long start = micros();
+    if (DataFetcher::updateData()) {
+      EnhancedCandleStick::update(ui_chart, STOCK_SYMBOL);
+    }
+    lv_timer_handler();
+    lv_refr_now(NULL); // Render every frame regardless of the refresh period
+    frame_us.push_back(micros() - start);
+  }
+
+  Serial.printf("\n=== SIM %dx%d, %s renderer, %d frames ===\n", SIM_HOR_RES,
+                SIM_VER_RES, USE_CANVAS_RENDERER ? "canvas" : "object",
+                frames);
+  printFrameStats(frame_us, simFlushedPixels() - pixels_before);
+  return 0;
+}
+
+// Drives the real fetch task against a stand-in server for `seconds`. The
+// chart counts as stale whenever its newest bar is more than one interval
+// and one poll behind the clock; each stale stretch is one recovery.
+static int runReplay(const char *url, int seconds) {
+  DATA_BASE_URL = normalizeBaseUrl(url);
+  if (DATA_BASE_URL.isEmpty() || DATA_BASE_URL.startsWith("https:")) {
+    Serial.printf("Need a plain http:// base URL, got %s\n", url);
+    return 1;
+  }
+  USE_TEST_DATA = false;
+  ENFORCE_MARKET_HOURS = false; // Stand-in data has no sessions
+
+  if (!FetchTask::begin() || !DataFetcher::initialize(STOCK_SYMBOL)) {
+    Serial.println("DataFetcher failed to initialize");
+    return 1;
+  }
+  EnhancedCandleStick::create(ui_chart, STOCK_SYMBOL);
+
+  std::vector<uint32_t> frame_us;
+  uint64_t pixels_before = simFlushedPixels();
+  time_t stale_after = CANDLE_COLLECTION_DURATION +
+                       std::max(1000, INTRADAY_UPDATE_INTERVAL) / 1000 + 1;
+  unsigned long run_start = millis();
+  unsigned long first_bar_ms = 0;
+  unsigned long stale_since = 0;
+  unsigned long stale_ms = 0;
+  unsigned long longest_stale_ms = 0;
+  uint32_t recoveries = 0;
+  uint32_t updates = 0;
+
+  while (millis() - run_start < (unsigned long)seconds * 1000) {
+    unsigned long start = micros();
+    if (DataFetcher::updateData()) {
+      EnhancedCandleStick::update(ui_chart, STOCK_SYMBOL);
+      updates++;
+    }
+    lv_timer_handler();
+    lv_refr_now(NULL);
+    frame_us.push_back(micros() - start);
+
+    const CandleStore &bars = DataFetcher::getStore();
+    unsigned long now_ms = millis();
+    if (bars.size() > 0 && first_bar_ms == 0) {
+      first_bar_ms = now_ms - run_start;
+    }
+    bool stale = first_bar_ms > 0 && time(nullptr) - bars.timestamp(0) >
+                                         stale_after;
+    if (stale && stale_since == 0) {
+      stale_since = now_ms;
+    } else if (!stale && stale_since != 0) {
+      recoveries++;
+      stale_ms += now_ms - stale_since;
+      longest_stale_ms = std::max(longest_stale_ms, now_ms - stale_since);
+      stale_since = 0;
+    }
+
+    unsigned long spent = (micros() - start) / 1000;
+    if (spent < SIM_FRAME_MS) {
+      delay(SIM_FRAME_MS - spent);
+    }
+  }
+  if (stale_since != 0) {
+    stale_ms += millis() - stale_since;
+    longest_stale_ms = std::max(longest_stale_ms, millis() - stale_since);
+  }
+
+  const CandleStore &bars = DataFetcher::getStore();
+  int gaps = 0;
+  for (int age = 1; age < bars.size(); age++) {
+    if (bars.timestamp(age - 1) - bars.timestamp(age) >
+        CANDLE_COLLECTION_DURATION) {
+      gaps++;
+    }
+  }
+  const http_session_stats_t &net = HttpSession::getStats();
+
+  Serial.printf("\n=== REPLAY %s %s/%s from %s, %d s ===\n",
+                STOCK_SYMBOL.c_str(), YAHOO_INTERVAL.c_str(),
+                YAHOO_RANGE.c_str(), DATA_BASE_URL.c_str(), seconds);
+  Serial.printf("First bar after %lu ms, %u chart updates, %d bars held, "
+                "%d gaps\n",
+                first_bar_ms, updates, bars.size(), gaps);
+  Serial.printf("Stale %lu ms in total, %u recoveries, longest %lu ms\n",
+                stale_ms, recoveries, longest_stale_ms);
+  if (net.requests > 0) {
+    Serial.printf("HTTP: %u requests over %u handshakes, %u failed, %u "
+                  "rejected, avg %u ms, max %u ms\n",
+                  net.requests, net.handshakes, net.failures, net.rejected,
+                  (unsigned)(net.total_ms / net.requests), net.max_ms);
+  }
+  printFrameStats(frame_us, simFlushedPixels() - pixels_before);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  int frames = 300;
+  int seconds = 60;
+  const char *ppm_path = NULL;
+  const char *url = NULL;
+  const char *symbol = NULL;
+  const char *interval = NULL;
+  const char *range = NULL;
+  bool canvas = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      frames = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--ppm") == 0 && i + 1 < argc) {
+      ppm_path = argv[++i];
+    } else if (strcmp(argv[i], "--canvas") == 0) {
+      canvas = true;
+    } else if (strcmp(argv[i], "--url") == 0 && i + 1 < argc) {
+      url = argv[++i];
+    } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+      seconds = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--symbol") == 0 && i + 1 < argc) {
+      symbol = argv[++i];
+    } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+      interval = argv[++i];
+    } else if (strcmp(argv[i], "--range") == 0 && i + 1 < argc) {
+      range = argv[++i];
+    }
+  }
+
+  beginSimDisplay();
+  ui_init();
+
+  loadConfig();
+  USE_CANVAS_RENDERER = canvas;
+  if (symbol != NULL && validateSymbol(symbol)) {
+    STOCK_SYMBOL = symbol;
+  }
+  if (interval != NULL && validateInterval(interval)) {
+    YAHOO_INTERVAL = interval;
+    syncCandleDurationWithInterval();
+  }
+  if (range != NULL && validateRange(range)) {
+    YAHOO_RANGE = range;
+  }
+
+  int result = (url != NULL) ? runReplay(url, seconds) : runTestData(frames);
+
+  const render_stats_t &render = EnhancedCandleStick::getRenderStats();
+  Serial.printf("Chart: %u renders, last %u us, max %u us, %u objects "
+                "touched last\n",
+                render.renders, render.last_render_us, render.max_render_us,
+                render.objects_touched);
+
+  if (ppm_path != NULL) {
+    Serial.printf("Screenshot %s %s\n", ppm_path,
+                  writeSimPpm(ppm_path) ? "written" : "failed");
+  }
+  return result;
+}
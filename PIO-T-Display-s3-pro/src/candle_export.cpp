@@ -0,0 +1,36 @@
+#include "candle_export.h"
+#include <algorithm>
+
+size_t CandleExport::write(const CandleStore &store, const char *symbol,
+                           const char *interval, int bars,
+                           CandleExportSink sink, void *ctx) {
+  bars = std::max(0, std::min(bars, store.size()));
+
+  candle_export_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = CANDLE_EXPORT_MAGIC;
+  header.version = CANDLE_EXPORT_VERSION;
+  header.header_size = sizeof(header);
+  strlcpy(header.symbol, symbol, sizeof(header.symbol));
+  strlcpy(header.interval, interval, sizeof(header.interval));
+  header.count = bars;
+  header.price_scale = CANDLE_PRICE_SCALE;
+  header.base_price = store.basePrice();
+  header.base_time = store.baseTime();
+  sink((const uint8_t *)&header, sizeof(header), ctx);
+
+  // Chunks come straight out of the store's columns, at most two runs
+  // each where the ring wraps
+  int starts[2], lengths[2];
+  int runs = store.runs(bars, starts, lengths);
+  size_t bytes = sizeof(header);
+  for (int col = 0; col < CANDLE_COL_COUNT; col++) {
+    const uint8_t *data = store.columnData((candle_column_t)col);
+    size_t width = CandleStore::columnWidth((candle_column_t)col);
+    for (int r = 0; r < runs; r++) {
+      sink(data + starts[r] * width, lengths[r] * width, ctx);
+      bytes += lengths[r] * width;
+    }
+  }
+  return bytes;
+}
@@ -0,0 +1,45 @@
+#ifndef CANDLE_EXPORT_H
+#define CANDLE_EXPORT_H
+
+#include "candle_store.h"
+#include <Arduino.h>
+
+#define CANDLE_EXPORT_MAGIC 0x4C444E43 // "CNDL" little-endian
+#define CANDLE_EXPORT_VERSION 1
+
+// /candles.bin: this header, then one little-endian column after another,
+// each oldest bar first: open, high, low, close (int32 ticks; price is
+// base_price + ticks / price_scale, INT32_MIN when missing), time (uint32
+// seconds after base_time), volume (uint32), complete (uint8). With
+// ?since=<unix seconds> only bars newer than that are sent.
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t header_size;
+  char symbol[16];
+  char interval[8];
+  uint32_t count;
+  uint32_t price_scale;
+  double base_price;
+  int64_t base_time;
+} candle_export_header_t;
+
+// Called once per chunk, in file order
+typedef void (*CandleExportSink)(const uint8_t *data, size_t len, void *ctx);
+
+// Encoder behind /candles.bin, kept apart from the web server so the host
+// tests can decode what it writes
+class CandleExport {
+public:
+  // Writes the newest `bars` bars: the header, then each column in at most
+  // two chunks that point straight into the store. Returns the bytes sent.
+  static size_t write(const CandleStore &store, const char *symbol,
+                      const char *interval, int bars, CandleExportSink sink,
+                      void *ctx);
+  static size_t encodedSize(int bars) {
+    return sizeof(candle_export_header_t) +
+           bars * (6 * sizeof(uint32_t) + sizeof(uint8_t));
+  }
+};
+
+#endif // CANDLE_EXPORT_H
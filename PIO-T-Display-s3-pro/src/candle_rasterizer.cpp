@@ -0,0 +1,64 @@
+#include "candle_rasterizer.h"
+#include <algorithm>
+#include <string.h>
+
+// Clip a rectangle to the buffer; returns false when nothing is left
+static bool clip_rect(int width, int height, int *x, int *y, int *w, int *h) {
+  int x1 = std::max(*x, 0);
+  int y1 = std::max(*y, 0);
+  int x2 = std::min(*x + *w, width);
+  int y2 = std::min(*y + *h, height);
+  if (x1 >= x2 || y1 >= y2) {
+    return false;
+  }
+  *x = x1;
+  *y = y1;
+  *w = x2 - x1;
+  *h = y2 - y1;
+  return true;
+}
+
+void CandleRasterizer::clear(lv_color_t *buf, int width, int height,
+                             lv_color_t color) {
+  size_t pixels = (size_t)width * height;
+  if (color.full == 0) {
+    memset(buf, 0, pixels * sizeof(lv_color_t));
+    return;
+  }
+  std::fill(buf, buf + pixels, color);
+}
+
+void CandleRasterizer::fillRect(lv_color_t *buf, int width, int height, int x,
+                                int y, int w, int h, lv_color_t color) {
+  if (!clip_rect(width, height, &x, &y, &w, &h)) {
+    return;
+  }
+
+  lv_color_t *row = buf + (size_t)y * width + x;
+  if (w == 1) {
+    // Wicks: one pixel per row
+    for (int j = 0; j < h; j++, row += width) {
+      *row = color;
+    }
+    return;
+  }
+
+  for (int j = 0; j < h; j++, row += width) {
+    std::fill(row, row + w, color);
+  }
+}
+
+void CandleRasterizer::blendRect(lv_color_t *buf, int width, int height, int x,
+                                 int y, int w, int h, lv_color_t color,
+                                 lv_opa_t opa) {
+  if (!clip_rect(width, height, &x, &y, &w, &h)) {
+    return;
+  }
+
+  lv_color_t *row = buf + (size_t)y * width + x;
+  for (int j = 0; j < h; j++, row += width) {
+    for (int i = 0; i < w; i++) {
+      row[i] = lv_color_mix(color, row[i], opa);
+    }
+  }
+}
@@ -0,0 +1,18 @@
+#ifndef CANDLE_RASTERIZER_H
+#define CANDLE_RASTERIZER_H
+
+#include <lvgl.h>
+
+// Span fills straight into an lv_canvas buffer (row-major, width * height
+// pixels). Everything is clipped to the buffer, so callers can pass raw
+// chart coordinates.
+class CandleRasterizer {
+public:
+    static void clear(lv_color_t *buf, int width, int height, lv_color_t color);
+    static void fillRect(lv_color_t *buf, int width, int height, int x, int y,
+                         int w, int h, lv_color_t color);
+    static void blendRect(lv_color_t *buf, int width, int height, int x, int y,
+                          int w, int h, lv_color_t color, lv_opa_t opa);
+};
+
+#endif // CANDLE_RASTERIZER_H
@@ -0,0 +1,203 @@
+#include "candle_resampler.h"
+#include "market_hours.h"
+#include <algorithm>
+
+#define SECONDS_PER_DAY 86400
+
+// Static member definitions
+time_t CandleResampler::cached_day = 0;
+time_t CandleResampler::cached_open = 0;
+
+int CandleResampler::bucketSeconds(const String &interval) {
+  if (interval == "1m")
+    return 60;
+  if (interval == "2m")
+    return 120;
+  if (interval == "5m")
+    return 300;
+  if (interval == "15m")
+    return 900;
+  if (interval == "30m")
+    return 1800;
+  if (interval == "60m" || interval == "1h")
+    return 3600;
+  if (interval == "90m")
+    return 5400;
+  if (interval == "1d")
+    return SECONDS_PER_DAY;
+
+  // 5d, 1wk, 1mo and 3mo follow the calendar, not a fixed length
+  return 0;
+}
+
+bool CandleResampler::canResample(int base_seconds, int seconds) {
+  return base_seconds > 0 && base_seconds < SECONDS_PER_DAY &&
+         seconds > base_seconds && seconds <= SECONDS_PER_DAY &&
+         seconds % base_seconds == 0;
+}
+
+time_t CandleResampler::sessionOpen(time_t t) {
+  // Consecutive bars nearly always share a day, so mktime runs once a day
+  if (cached_day != 0 && t >= cached_day && t < cached_day + SECONDS_PER_DAY) {
+    return cached_open;
+  }
+
+  struct tm day;
+  localtime_r(&t, &day);
+  day.tm_hour = 0;
+  day.tm_min = 0;
+  day.tm_sec = 0;
+  day.tm_isdst = -1;
+  cached_day = mktime(&day);
+
+  day.tm_hour = StockTracker::MARKET_OPEN_HOUR;
+  day.tm_min = StockTracker::MARKET_OPEN_MINUTE;
+  day.tm_isdst = -1;
+  cached_open = mktime(&day);
+  return cached_open;
+}
+
+time_t CandleResampler::bucketStart(time_t t, int seconds) {
+  time_t open = sessionOpen(t);
+  if (seconds >= SECONDS_PER_DAY) {
+    return open;
+  }
+
+  // Floor division, so pre-market bars land on buckets before the open
+  time_t offset = t - open;
+  time_t buckets = offset / seconds;
+  if (offset < 0 && offset % seconds != 0) {
+    buckets--;
+  }
+  return open + buckets * seconds;
+}
+
+static void addBar(enhanced_candle_t &bucket, const enhanced_candle_t &bar,
+                   bool &priced) {
+  bucket.volume += bar.volume;
+  if (bar.open <= 0 || bar.high <= 0 || bar.low <= 0 || bar.close <= 0) {
+    return;
+  }
+
+  if (!priced) {
+    bucket.open = bar.open;
+    bucket.high = bar.high;
+    bucket.low = bar.low;
+    priced = true;
+  } else {
+    bucket.high = std::max(bucket.high, bar.high);
+    bucket.low = std::min(bucket.low, bar.low);
+  }
+  bucket.close = bar.close;
+}
+
+static void startBucket(enhanced_candle_t &bucket, time_t start) {
+  memset(&bucket, 0, sizeof(bucket));
+  bucket.timestamp = start;
+}
+
+bool CandleResampler::fold(const CandleStore &src, int base_seconds,
+                           time_t bucket_start, int seconds,
+                           enhanced_candle_t *out) {
+  // Daily buckets also hold the pre-market bars before their open
+  time_t stop = (seconds >= SECONDS_PER_DAY) ? bucket_start - SECONDS_PER_DAY
+                                             : bucket_start;
+
+  // Members are contiguous; find them walking back from the newest bar
+  int newest_member = -1;
+  int oldest_member = -1;
+  for (int age = 0; age < src.size(); age++) {
+    time_t t = src.timestamp(age);
+    if (t < stop) {
+      break;
+    }
+    if (bucketStart(t, seconds) == bucket_start) {
+      if (newest_member < 0) {
+        newest_member = age;
+      }
+      oldest_member = age;
+    } else if (newest_member >= 0) {
+      break;
+    }
+  }
+  if (newest_member < 0) {
+    return false;
+  }
+
+  bool priced = false;
+  startBucket(*out, bucket_start);
+  for (int age = oldest_member; age >= newest_member; age--) {
+    addBar(*out, src.get(age), priced);
+  }
+
+  // Finished once a later bar exists or the last member reaches the end
+  out->is_complete =
+      newest_member > 0 ||
+      (src.isComplete(newest_member) &&
+       src.timestamp(newest_member) + base_seconds >= bucket_start + seconds);
+  return priced;
+}
+
+void CandleResampler::rebuild(const CandleStore &src, int base_seconds,
+                              CandleStore &dst, int seconds) {
+  dst.clear();
+
+  enhanced_candle_t bucket;
+  enhanced_candle_t bar;
+  bool priced = false;
+  bool started = false;
+
+  for (int age = src.size() - 1; age >= 0; age--) {
+    bar = src.get(age);
+    time_t start = bucketStart(bar.timestamp, seconds);
+
+    if (!started || start != bucket.timestamp) {
+      if (started && priced) {
+        bucket.is_complete = true;
+        dst.push(bucket);
+      }
+      startBucket(bucket, start);
+      priced = false;
+      started = true;
+    }
+    addBar(bucket, bar, priced);
+  }
+
+  if (started && priced) {
+    bucket.is_complete =
+        bar.is_complete &&
+        bar.timestamp + base_seconds >= bucket.timestamp + seconds;
+    dst.push(bucket);
+  }
+}
+
+void CandleResampler::update(const CandleStore &src, int base_seconds,
+                             CandleStore &dst, int seconds, time_t changed) {
+  time_t start = bucketStart(changed, seconds);
+  enhanced_candle_t bucket;
+  if (!fold(src, base_seconds, start, seconds, &bucket)) {
+    return;
+  }
+
+  if (dst.size() == 0 || start > dst.timestamp(0)) {
+    // A new bucket closes the one before it
+    if (dst.size() > 0 && !dst.isComplete(0)) {
+      enhanced_candle_t previous = dst.get(0);
+      previous.is_complete = true;
+      dst.replace(0, previous);
+    }
+    dst.push(bucket);
+    return;
+  }
+
+  for (int age = 0; age < dst.size(); age++) {
+    time_t stored = dst.timestamp(age);
+    if (stored == start) {
+      dst.replace(age, bucket);
+      return;
+    }
+    if (stored < start) {
+      break; // Same no-insert policy as DataFetcher::mergeCandle
+    }
+  }
+}
@@ -0,0 +1,37 @@
+#ifndef CANDLE_RESAMPLER_H
+#define CANDLE_RESAMPLER_H
+
+#include "candle_store.h"
+#include <Arduino.h>
+#include <time.h>
+
+// Folds fine bars from one CandleStore into coarser bars in another.
+// Buckets are aligned to the local session open, the way Yahoo labels its
+// own intraday bars (60m bars start at :30, 1d bars at the open). Bars with
+// missing prices are skipped; a bucket with no priced bars is left out.
+class CandleResampler {
+private:
+  static time_t cached_day;  // Local midnight the cached open belongs to
+  static time_t cached_open; // Session open on that day
+
+  static time_t sessionOpen(time_t t);
+  static bool fold(const CandleStore &src, int base_seconds,
+                   time_t bucket_start, int seconds, enhanced_candle_t *out);
+
+public:
+  // Bucket length for an interval that can be folded locally, 0 if not
+  static int bucketSeconds(const String &interval);
+  static bool canResample(int base_seconds, int seconds);
+
+  static time_t bucketStart(time_t t, int seconds);
+
+  // Replaces dst with src folded into `seconds`-long buckets
+  static void rebuild(const CandleStore &src, int base_seconds,
+                      CandleStore &dst, int seconds);
+
+  // Re-folds the bucket holding a src bar that was just added or replaced
+  static void update(const CandleStore &src, int base_seconds,
+                     CandleStore &dst, int seconds, time_t changed);
+};
+
+#endif // CANDLE_RESAMPLER_H
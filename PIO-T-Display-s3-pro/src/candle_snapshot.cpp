@@ -0,0 +1,259 @@
+#include "candle_snapshot.h"
+#include "log.h"
+#include <LittleFS.h>
+#include <algorithm>
+#include <esp_rom_crc.h>
+#include <stddef.h>
+
+// Static member definitions
+bool CandleSnapshot::mounted = false;
+unsigned long CandleSnapshot::last_save = 0;
+time_t CandleSnapshot::saved_newest = 0;
+char CandleSnapshot::saved_path[40] = "";
+std::atomic<uint8_t *> CandleSnapshot::pending{NULL};
+size_t CandleSnapshot::pending_size = 0;
+char CandleSnapshot::pending_path[40] = "";
+
+bool CandleSnapshot::begin() {
+  // Formats the partition on first use, which takes a few seconds once
+  mounted = LittleFS.begin(true);
+  if (!mounted) {
+    LOG_W("LittleFS mount failed, snapshots disabled");
+    return false;
+  }
+
+  // A reset mid-write leaves a partial temp file that nothing else reads
+  File root = LittleFS.open("/");
+  File entry = root.openNextFile();
+  while (entry) {
+    String entry_path = entry.path();
+    entry.close();
+    if (entry_path.endsWith(".tmp")) {
+      LittleFS.remove(entry_path);
+      LOG_I("Removed partial snapshot %s", entry_path.c_str());
+    }
+    entry = root.openNextFile();
+  }
+  root.close();
+
+  LOG_I("LittleFS: %u of %u bytes used", (unsigned)LittleFS.usedBytes(),
+        (unsigned)LittleFS.totalBytes());
+  return true;
+}
+
+String CandleSnapshot::pathFor(const char *symbol, const char *interval) {
+  return String("/snap_") + symbol + "_" + interval + ".bin";
+}
+
+uint32_t CandleSnapshot::crc32(uint32_t crc, const uint8_t *data, size_t len) {
+  return esp_rom_crc32_le(crc, data, len);
+}
+
+size_t CandleSnapshot::copyColumns(const CandleStore &store,
+                                   const char *symbol, const char *interval,
+                                   uint8_t *out) {
+  int count = store.size();
+
+  // The store's own base and columns, so every bar is written exactly as
+  // stored; the CRC is left zero for seal()
+  snapshot_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = SNAPSHOT_MAGIC;
+  header.version = SNAPSHOT_VERSION;
+  header.header_size = sizeof(header);
+  strlcpy(header.symbol, symbol, sizeof(header.symbol));
+  strlcpy(header.interval, interval, sizeof(header.interval));
+  header.count = count;
+  header.base_price = store.basePrice();
+  header.base_time = store.baseTime();
+  memcpy(out, &header, sizeof(header));
+
+  // Oldest first, from at most two runs where the ring wraps
+  int starts[2], lengths[2];
+  int runs = store.runs(count, starts, lengths);
+  uint8_t *dst = out + sizeof(header);
+  for (int col = 0; col < CANDLE_COL_COUNT; col++) {
+    const uint8_t *data = store.columnData((candle_column_t)col);
+    size_t width = CandleStore::columnWidth((candle_column_t)col);
+    for (int r = 0; r < runs; r++) {
+      memcpy(dst, data + starts[r] * width, lengths[r] * width);
+      dst += lengths[r] * width;
+    }
+  }
+  return encodedSize(count);
+}
+
+void CandleSnapshot::seal(uint8_t *image, size_t len) {
+  // The header's crc field is still zero here, as decode() expects
+  uint32_t crc = crc32(0, image, len);
+  memcpy(image + offsetof(snapshot_header_t, crc), &crc, sizeof(crc));
+}
+
+size_t CandleSnapshot::encode(const CandleStore &store, const char *symbol,
+                              const char *interval, uint8_t *out) {
+  size_t len = copyColumns(store, symbol, interval, out);
+  seal(out, len);
+  return len;
+}
+
+time_t CandleSnapshot::decode(const uint8_t *image, size_t len,
+                              const char *symbol, const char *interval,
+                              CandleStore &store) {
+  snapshot_header_t header;
+  if (len < sizeof(header)) {
+    return 0;
+  }
+  memcpy(&header, image, sizeof(header));
+
+  if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+      header.header_size != sizeof(header) ||
+      len != encodedSize(header.count) ||
+      strncmp(header.symbol, symbol, sizeof(header.symbol)) != 0 ||
+      strncmp(header.interval, interval, sizeof(header.interval)) != 0) {
+    return 0;
+  }
+
+  uint32_t stored_crc = header.crc;
+  header.crc = 0;
+  uint32_t crc = crc32(0, (const uint8_t *)&header, sizeof(header));
+  crc = crc32(crc, image + sizeof(header),
+              header.count * SNAPSHOT_BYTES_PER_BAR);
+  if (crc != stored_crc) {
+    return 0;
+  }
+
+  const uint8_t *columns[CANDLE_COL_COUNT];
+  const uint8_t *src = image + sizeof(header);
+  for (int col = 0; col < CANDLE_COL_COUNT; col++) {
+    columns[col] = src;
+    src += header.count * CandleStore::columnWidth((candle_column_t)col);
+  }
+
+  store.loadColumns(header.base_price, header.base_time, columns,
+                    header.count);
+  return (store.size() > 0) ? store.timestamp(0) : 0;
+}
+
+void CandleSnapshot::checkpoint(const String &symbol, const String &interval,
+                                const CandleStore &store, bool force) {
+  if (!mounted || store.size() == 0 || symbol.length() == 0 ||
+      pending.load(std::memory_order_acquire) != NULL) {
+    return;
+  }
+
+  // Only whole new bars count; refreshes of the forming bar do not
+  String path = pathFor(symbol.c_str(), interval.c_str());
+  int new_bars = 0;
+  if (path != saved_path) {
+    new_bars = store.size();
+  } else {
+    while (new_bars < store.size() &&
+           store.timestamp(new_bars) > saved_newest) {
+      new_bars++;
+    }
+  }
+
+  if (new_bars == 0 ||
+      (!force && (new_bars < SNAPSHOT_MIN_NEW_BARS ||
+                  millis() - last_save < SNAPSHOT_PERIOD_MS))) {
+    return;
+  }
+
+  size_t size = encodedSize(store.size());
+  uint8_t *image = (uint8_t *)ps_malloc(size);
+  if (image == NULL) {
+    LOG_E("No PSRAM for a %u byte snapshot", (unsigned)size);
+    return;
+  }
+
+  // Only the column copy happens here; the CRC is left to the fetch task
+  copyColumns(store, symbol.c_str(), interval.c_str(), image);
+  strlcpy(pending_path, path.c_str(), sizeof(pending_path));
+  pending_size = size;
+  pending.store(image, std::memory_order_release);
+
+  last_save = millis();
+  saved_newest = store.timestamp(0);
+  strlcpy(saved_path, path.c_str(), sizeof(saved_path));
+}
+
+time_t CandleSnapshot::load(const String &symbol, const String &interval,
+                            CandleStore &store) {
+  String path = pathFor(symbol.c_str(), interval.c_str());
+  if (!mounted || !LittleFS.exists(path)) {
+    return 0;
+  }
+
+  unsigned long start = millis();
+  File file = LittleFS.open(path, "r");
+  size_t size = file.size();
+  uint8_t *image = (uint8_t *)ps_malloc(size);
+  size_t read = (image != NULL) ? file.read(image, size) : 0;
+  file.close();
+
+  time_t newest = (read == size)
+                      ? decode(image, size, symbol.c_str(), interval.c_str(),
+                               store)
+                      : 0;
+  free(image);
+
+  if (newest == 0) {
+    // Corrupt or from another format version; the next checkpoint rewrites
+    LOG_W("Snapshot %s rejected", path.c_str());
+    LittleFS.remove(path);
+    store.clear();
+    return 0;
+  }
+
+  saved_newest = newest;
+  strlcpy(saved_path, path.c_str(), sizeof(saved_path));
+  LOG_I("Restored %d bars from %s in %lu ms", store.size(), path.c_str(),
+        millis() - start);
+  return newest;
+}
+
+void CandleSnapshot::pruneFor(size_t bytes) {
+  // Other symbols' snapshots go first when flash runs short
+  File root = LittleFS.open("/");
+  File entry = root.openNextFile();
+  while (entry && LittleFS.totalBytes() - LittleFS.usedBytes() < 2 * bytes) {
+    String entry_path = entry.path();
+    entry.close();
+    if (entry_path.startsWith("/snap_") && entry_path != pending_path) {
+      LittleFS.remove(entry_path);
+      LOG_I("Pruned snapshot %s", entry_path.c_str());
+    }
+    entry = root.openNextFile();
+  }
+  root.close();
+}
+
+void CandleSnapshot::service() {
+  uint8_t *image = pending.load(std::memory_order_acquire);
+  if (image == NULL) {
+    return;
+  }
+
+  unsigned long start = millis();
+  seal(image, pending_size);
+  pruneFor(pending_size);
+
+  // Written beside the old file and renamed over it; LittleFS replaces
+  // the target atomically, so a reset at any point leaves one complete
+  // snapshot. LittleFS spreads the erases.
+  String temp_path = String(pending_path) + ".tmp";
+  File file = LittleFS.open(temp_path, "w");
+  size_t written = file ? file.write(image, pending_size) : 0;
+  file.close();
+
+  if (written == pending_size && LittleFS.rename(temp_path, pending_path)) {
+    LOG_D("Snapshot: %u bytes to %s in %lu ms", (unsigned)pending_size,
+          pending_path, millis() - start);
+  } else {
+    LittleFS.remove(temp_path);
+    LOG_E("Snapshot write failed for %s", pending_path);
+  }
+
+  free(image);
+  pending.store(NULL, std::memory_order_release);
+}
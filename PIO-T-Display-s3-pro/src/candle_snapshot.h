@@ -0,0 +1,80 @@
+#ifndef CANDLE_SNAPSHOT_H
+#define CANDLE_SNAPSHOT_H
+
+#include "candle_store.h"
+#include <Arduino.h>
+#include <atomic>
+
+#define SNAPSHOT_MAGIC 0x4E534353 // "SCSN" little-endian
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_PERIOD_MS 300000 // At most one flash write per 5 minutes
+#define SNAPSHOT_MIN_NEW_BARS 5   // ...and only once this many bars are new
+#define SNAPSHOT_BYTES_PER_BAR (6 * sizeof(uint32_t) + sizeof(uint8_t))
+
+// On-flash layout: this header, then the CandleStore's own columns as
+// stored, oldest bar first: open, high, low, close (int32 ticks from
+// base_price), time (uint32 seconds from base_time), volume (uint32),
+// complete (uint8). The CRC covers the header with crc zeroed, then the
+// columns.
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t header_size;
+  char symbol[16];
+  char interval[8];
+  uint32_t count;
+  double base_price;
+  int64_t base_time;
+  uint32_t crc;
+} snapshot_header_t;
+
+// Checkpoints a CandleStore to LittleFS, one file per symbol and interval,
+// so a reboot or a switch back shows history before the network answers.
+// Only the column copy happens on the UI core; the CRC and the flash write
+// are handed to the fetch task so a slow erase never stalls a frame.
+class CandleSnapshot {
+private:
+  static bool mounted;
+  static unsigned long last_save;
+  static time_t saved_newest;
+  static char saved_path[40]; // File saved_newest belongs to
+
+  // Encoded file waiting for the fetch task, NULL when idle
+  static std::atomic<uint8_t *> pending;
+  static size_t pending_size;
+  static char pending_path[40];
+
+  static String pathFor(const char *symbol, const char *interval);
+  static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len);
+  static size_t copyColumns(const CandleStore &store, const char *symbol,
+                            const char *interval, uint8_t *out);
+  static void seal(uint8_t *image, size_t len);
+  static void pruneFor(size_t bytes);
+
+public:
+  static bool begin();
+
+  // Encoded size for `count` bars, and the (pure) codec behind save/load
+  static size_t encodedSize(int count) {
+    return sizeof(snapshot_header_t) + count * SNAPSHOT_BYTES_PER_BAR;
+  }
+  static size_t encode(const CandleStore &store, const char *symbol,
+                       const char *interval, uint8_t *out);
+  // Newest timestamp restored, 0 if the image is unusable
+  static time_t decode(const uint8_t *image, size_t len, const char *symbol,
+                       const char *interval, CandleStore &store);
+
+  // UI core. Queues a write when enough new bars arrived and the rate limit
+  // allows; `force` skips the limits but still needs something new.
+  static void checkpoint(const String &symbol, const String &interval,
+                         const CandleStore &store, bool force);
+  // UI core. Fills `store` from flash in one read; returns the newest
+  // timestamp restored, 0 if there was no usable snapshot.
+  static time_t load(const String &symbol, const String &interval,
+                     CandleStore &store);
+
+  // Fetch task. Writes a queued checkpoint, if any.
+  static void service();
+};
+
+#endif // CANDLE_SNAPSHOT_H
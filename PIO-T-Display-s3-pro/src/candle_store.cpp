@@ -0,0 +1,249 @@
+#include "candle_store.h"
+#include <algorithm>
+#include <math.h>
+
+CandleStore::CandleStore()
+    : open_ticks(NULL), high_ticks(NULL), low_ticks(NULL), close_ticks(NULL),
+      time_offsets(NULL), volumes(NULL), complete(NULL), extrema_lows(NULL),
+      extrema_highs(NULL), slots(0) {
+  clear();
+}
+
+void CandleStore::release() {
+  free(open_ticks);
+  free(high_ticks);
+  free(low_ticks);
+  free(close_ticks);
+  free(time_offsets);
+  free(volumes);
+  free(complete);
+  free(extrema_lows);
+  free(extrema_highs);
+  open_ticks = high_ticks = low_ticks = close_ticks = NULL;
+  time_offsets = volumes = NULL;
+  complete = NULL;
+  extrema_lows = extrema_highs = NULL;
+  extrema.attach(NULL, NULL, 0);
+  slots = 0;
+}
+
+bool CandleStore::allocate(int capacity) {
+  release();
+
+  size_t nodes = ExtremaTree<int32_t>::nodesFor(capacity);
+  open_ticks = (int32_t *)ps_malloc(capacity * sizeof(int32_t));
+  high_ticks = (int32_t *)ps_malloc(capacity * sizeof(int32_t));
+  low_ticks = (int32_t *)ps_malloc(capacity * sizeof(int32_t));
+  close_ticks = (int32_t *)ps_malloc(capacity * sizeof(int32_t));
+  time_offsets = (uint32_t *)ps_malloc(capacity * sizeof(uint32_t));
+  volumes = (uint32_t *)ps_malloc(capacity * sizeof(uint32_t));
+  complete = (uint8_t *)ps_malloc(capacity * sizeof(uint8_t));
+  extrema_lows = (int32_t *)ps_malloc(nodes * sizeof(int32_t));
+  extrema_highs = (int32_t *)ps_malloc(nodes * sizeof(int32_t));
+
+  if (!open_ticks || !high_ticks || !low_ticks || !close_ticks ||
+      !time_offsets || !volumes || !complete || !extrema_lows ||
+      !extrema_highs) {
+    release();
+    clear();
+    return false;
+  }
+
+  slots = capacity;
+  extrema.attach(extrema_lows, extrema_highs, capacity);
+  clear();
+  return true;
+}
+
+void CandleStore::clear() {
+  extrema.clear();
+  base_price = 0.0;
+  base_time = 0;
+  newest = -1;
+  count = 0;
+}
+
+int32_t CandleStore::toTicks(float price) const {
+  if (price <= 0) {
+    return CANDLE_NO_PRICE;
+  }
+  double ticks = round((price - base_price) * CANDLE_PRICE_SCALE);
+  ticks = std::max(ticks, (double)INT32_MIN + 1);
+  ticks = std::min(ticks, (double)INT32_MAX);
+  return (int32_t)ticks;
+}
+
+float CandleStore::fromTicks(int32_t ticks) const {
+  if (ticks == CANDLE_NO_PRICE) {
+    return 0.0f;
+  }
+  return (float)(base_price + (double)ticks / CANDLE_PRICE_SCALE);
+}
+
+void CandleStore::write(int slot, const enhanced_candle_t &candle) {
+  // The first real price and time anchor every offset after it
+  if (base_price == 0.0) {
+    base_price = std::max({candle.close, candle.open, candle.high, candle.low,
+                           0.0f});
+  }
+  if (base_time == 0) {
+    base_time = candle.timestamp;
+  }
+
+  open_ticks[slot] = toTicks(candle.open);
+  high_ticks[slot] = toTicks(candle.high);
+  low_ticks[slot] = toTicks(candle.low);
+  close_ticks[slot] = toTicks(candle.close);
+  time_offsets[slot] =
+      (candle.timestamp > base_time) ? candle.timestamp - base_time : 0;
+  volumes[slot] = candle.volume;
+  complete[slot] = candle.is_complete ? 1 : 0;
+  index(slot);
+}
+
+void CandleStore::index(int slot) {
+  // Bars with missing OHLC values never take part in the scaling
+  if (open_ticks[slot] != CANDLE_NO_PRICE &&
+      high_ticks[slot] != CANDLE_NO_PRICE &&
+      low_ticks[slot] != CANDLE_NO_PRICE &&
+      close_ticks[slot] != CANDLE_NO_PRICE) {
+    extrema.set(slot, low_ticks[slot], high_ticks[slot]);
+  } else {
+    extrema.erase(slot);
+  }
+}
+
+void CandleStore::push(const enhanced_candle_t &candle) {
+  if (slots == 0) {
+    return;
+  }
+  if (count < slots) {
+    count++;
+  }
+  newest = (newest + 1) % slots;
+  write(newest, candle);
+}
+
+void CandleStore::replace(int age, const enhanced_candle_t &candle) {
+  if (age < 0 || age >= count) {
+    return;
+  }
+  write(slot(age), candle);
+}
+
+enhanced_candle_t CandleStore::get(int age) const {
+  int s = slot(age);
+  enhanced_candle_t candle;
+  candle.open = fromTicks(open_ticks[s]);
+  candle.high = fromTicks(high_ticks[s]);
+  candle.low = fromTicks(low_ticks[s]);
+  candle.close = fromTicks(close_ticks[s]);
+  candle.volume = volumes[s];
+  candle.timestamp = base_time + time_offsets[s];
+  candle.is_complete = complete[s] != 0;
+  return candle;
+}
+
+bool CandleStore::extremaOf(int bars, float *low, float *high) const {
+  int32_t low_ticks_found = std::numeric_limits<int32_t>::max();
+  int32_t high_ticks_found = std::numeric_limits<int32_t>::lowest();
+
+  // The newest bars may wrap around the end of the ring
+  int starts[2], lengths[2];
+  int run_count = runs(bars, starts, lengths);
+  for (int r = 0; r < run_count; r++) {
+    extrema.query(starts[r], starts[r] + lengths[r] - 1, &low_ticks_found,
+                  &high_ticks_found);
+  }
+
+  if (low_ticks_found == std::numeric_limits<int32_t>::max()) {
+    *low = std::numeric_limits<float>::max();
+    *high = std::numeric_limits<float>::lowest();
+    return false;
+  }
+
+  *low = fromTicks(low_ticks_found);
+  *high = fromTicks(high_ticks_found);
+  return true;
+}
+
+size_t CandleStore::bytesPerBar() const {
+  size_t columns = 4 * sizeof(int32_t) + sizeof(uint32_t) * 2 + sizeof(uint8_t);
+  if (slots == 0) {
+    return columns;
+  }
+  // Extrema nodes amortised over the bars they index
+  return columns + 2 * ExtremaTree<int32_t>::nodesFor(slots) *
+                       sizeof(int32_t) / slots;
+}
+
+int CandleStore::runs(int bars, int starts[2], int lengths[2]) const {
+  bars = std::min(bars, count);
+  if (bars <= 0) {
+    return 0;
+  }
+
+  int first = slot(bars - 1);
+  starts[0] = first;
+  if (first <= newest) {
+    lengths[0] = bars;
+    return 1;
+  }
+  lengths[0] = slots - first;
+  starts[1] = 0;
+  lengths[1] = newest + 1;
+  return 2;
+}
+
+const uint8_t *CandleStore::columnData(candle_column_t column) const {
+  switch (column) {
+  case CANDLE_COL_OPEN:
+    return (const uint8_t *)open_ticks;
+  case CANDLE_COL_HIGH:
+    return (const uint8_t *)high_ticks;
+  case CANDLE_COL_LOW:
+    return (const uint8_t *)low_ticks;
+  case CANDLE_COL_CLOSE:
+    return (const uint8_t *)close_ticks;
+  case CANDLE_COL_TIME:
+    return (const uint8_t *)time_offsets;
+  case CANDLE_COL_VOLUME:
+    return (const uint8_t *)volumes;
+  case CANDLE_COL_COMPLETE:
+    return complete;
+  default:
+    return NULL;
+  }
+}
+
+void CandleStore::loadColumns(double base_price, time_t base_time,
+                              const uint8_t *const columns[CANDLE_COL_COUNT],
+                              int bars) {
+  clear();
+  int skip = std::max(0, bars - slots);
+  count = bars - skip;
+  if (count == 0) {
+    return;
+  }
+
+  // Copied as stored, so nothing is re-quantized on the way in
+  this->base_price = base_price;
+  this->base_time = base_time;
+  for (int col = 0; col < CANDLE_COL_COUNT; col++) {
+    size_t width = columnWidth((candle_column_t)col);
+    memcpy((uint8_t *)columnData((candle_column_t)col),
+           columns[col] + skip * width, count * width);
+  }
+  newest = count - 1;
+  for (int s = 0; s < count; s++) {
+    index(s);
+  }
+}
+
+int CandleStore::countSince(time_t since) const {
+  int bars = 0;
+  while (bars < count && timestamp(bars) > since) {
+    bars++;
+  }
+  return bars;
+}
@@ -0,0 +1,114 @@
+#ifndef CANDLE_STORE_H
+#define CANDLE_STORE_H
+
+#include "config.h"
+#include "extrema_tree.h"
+#include <Arduino.h>
+#include <time.h>
+
+#define CANDLE_PRICE_SCALE 10000      // Ticks per currency unit
+#define CANDLE_NO_PRICE INT32_MIN     // Tick value of a missing (0) price
+
+typedef struct {
+  float open;
+  float close;
+  float high;
+  float low;
+  uint32_t volume;
+  time_t timestamp;
+  bool is_complete; // Flag to indicate if candle is complete
+} enhanced_candle_t;
+
+// Columns in storage order, for bulk readers
+typedef enum {
+  CANDLE_COL_OPEN,     // int32 ticks from basePrice()
+  CANDLE_COL_HIGH,
+  CANDLE_COL_LOW,
+  CANDLE_COL_CLOSE,
+  CANDLE_COL_TIME,     // uint32 seconds from baseTime()
+  CANDLE_COL_VOLUME,   // uint32
+  CANDLE_COL_COMPLETE, // uint8
+  CANDLE_COL_COUNT
+} candle_column_t;
+
+// Column-oriented candle ring. Prices are int32 tick offsets from a base
+// price taken from the first stored bar, timestamps are uint32 second
+// offsets from the first stored bar's time. Bars are addressed by age,
+// 0 being the newest, so callers never see ring indices. Columns live in
+// PSRAM and are sized at runtime by allocate().
+class CandleStore {
+private:
+  int32_t *open_ticks;
+  int32_t *high_ticks;
+  int32_t *low_ticks;
+  int32_t *close_ticks;
+  uint32_t *time_offsets;
+  uint32_t *volumes;
+  uint8_t *complete;
+  int32_t *extrema_lows;
+  int32_t *extrema_highs;
+  ExtremaTree<int32_t> extrema; // Low/high ticks per slot
+  int slots;
+
+  double base_price;
+  time_t base_time;
+  int newest;
+  int count;
+
+  int slot(int age) const { return (newest - age + slots) % slots; }
+  int32_t toTicks(float price) const;
+  float fromTicks(int32_t ticks) const;
+  void write(int slot, const enhanced_candle_t &candle);
+  void index(int slot);
+  void release();
+
+public:
+  CandleStore();
+  ~CandleStore() { release(); }
+  // Owns its columns, so it is never copied
+  CandleStore(const CandleStore &) = delete;
+  CandleStore &operator=(const CandleStore &) = delete;
+
+  // (Re)sizes the ring, dropping every stored bar; false if out of memory
+  bool allocate(int capacity);
+  void clear();
+  int size() const { return count; }
+  int capacity() const { return slots; }
+
+  void push(const enhanced_candle_t &candle); // Evicts the oldest when full
+  void replace(int age, const enhanced_candle_t &candle);
+
+  enhanced_candle_t get(int age) const;
+  float close(int age) const { return fromTicks(close_ticks[slot(age)]); }
+  time_t timestamp(int age) const {
+    return base_time + time_offsets[slot(age)];
+  }
+  bool isComplete(int age) const { return complete[slot(age)] != 0; }
+
+  // Lowest low and highest high of the newest `bars` bars, skipping bars
+  // with missing prices; false when there is nothing valid
+  bool extremaOf(int bars, float *low, float *high) const;
+
+  size_t bytesPerBar() const;
+
+  // Raw access for bulk export without copying. The newest `bars` bars lie
+  // in at most two runs of ring slots; runs() stores them oldest first and
+  // returns how many there are.
+  int runs(int bars, int starts[2], int lengths[2]) const;
+  const uint8_t *columnData(candle_column_t column) const;
+  // Replaces every bar with `bars` rows given oldest first, one array per
+  // column in the same encoding, relative to `base_price` and `base_time`.
+  // The newest rows win when there are more than fit.
+  void loadColumns(double base_price, time_t base_time,
+                   const uint8_t *const columns[CANDLE_COL_COUNT], int bars);
+  static size_t columnWidth(candle_column_t column) {
+    return (column == CANDLE_COL_COMPLETE) ? sizeof(uint8_t)
+                                           : sizeof(uint32_t);
+  }
+  double basePrice() const { return base_price; }
+  time_t baseTime() const { return base_time; }
+  // Bars newer than `since`, counted from the newest
+  int countSince(time_t since) const;
+};
+
+#endif // CANDLE_STORE_H
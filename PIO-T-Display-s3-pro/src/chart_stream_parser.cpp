@@ -0,0 +1,256 @@
+#include "chart_stream_parser.h"
+#include "log.h"
+#include "metrics.h"
+#include <algorithm>
+
+ChartStreamParser::ChartStreamParser(ChartValueSink sink, void *ctx)
+    : sink(sink), sink_ctx(ctx) {
+  reset();
+}
+
+void ChartStreamParser::reset() {
+  state = STATE_VALUE;
+  escape = false;
+  in_quote = false;
+  active_field = -1;
+  pending_field = -1;
+  array_depth = 0;
+  for (int i = 0; i < CHART_FIELD_COUNT; i++) {
+    counts[i] = 0;
+    done[i] = false;
+  }
+  token_len = 0;
+  token_overflow = false;
+  token[0] = '\0';
+  bytes_consumed = 0;
+  failed = false;
+}
+
+int ChartStreamParser::fieldForKey(const char *key) const {
+  if (strcmp(key, "timestamp") == 0)
+    return CHART_FIELD_TIMESTAMP;
+
+  // OHLCV names only count inside indicators.quote, never in meta
+  if (!in_quote)
+    return -1;
+  if (strcmp(key, "open") == 0)
+    return CHART_FIELD_OPEN;
+  if (strcmp(key, "high") == 0)
+    return CHART_FIELD_HIGH;
+  if (strcmp(key, "low") == 0)
+    return CHART_FIELD_LOW;
+  if (strcmp(key, "close") == 0)
+    return CHART_FIELD_CLOSE;
+  if (strcmp(key, "volume") == 0)
+    return CHART_FIELD_VOLUME;
+  return -1;
+}
+
+void ChartStreamParser::emit(double value) {
+  uint32_t index = counts[active_field]++;
+  if (sink != NULL) {
+    sink((ChartField)active_field, index, value, sink_ctx);
+  }
+}
+
+void ChartStreamParser::endString() {
+  token[token_len] = '\0';
+  state = STATE_VALUE;
+}
+
+void ChartStreamParser::endLiteral() {
+  token[token_len] = '\0';
+  state = STATE_VALUE;
+
+  if (active_field < 0 || array_depth != 0)
+    return;
+
+  if (token_overflow) {
+    failed = true;
+    return;
+  }
+
+  if (strcmp(token, "null") == 0) {
+    emit(0.0);
+    return;
+  }
+
+  char *end = NULL;
+  double value = strtod(token, &end);
+  if (end == token) {
+    failed = true;
+    return;
+  }
+  emit(value);
+}
+
+bool ChartStreamParser::feed(const char *data, size_t len) {
+  for (size_t i = 0; i < len && !failed; i++) {
+    char c = data[i];
+
+    if (state == STATE_STRING) {
+      if (escape) {
+        escape = false;
+      } else if (c == '\\') {
+        escape = true;
+        continue;
+      } else if (c == '"') {
+        endString();
+        continue;
+      }
+      if (token_len < sizeof(token) - 1) {
+        token[token_len++] = c;
+      } else {
+        token_overflow = true;
+      }
+      continue;
+    }
+
+    if (state == STATE_LITERAL) {
+      if (isalnum((unsigned char)c) || c == '-' || c == '+' || c == '.') {
+        if (token_len < sizeof(token) - 1) {
+          token[token_len++] = c;
+        } else {
+          token_overflow = true;
+        }
+        continue;
+      }
+      endLiteral();
+      if (failed)
+        break;
+      // Fall through so the delimiter itself is handled below
+    }
+
+    switch (c) {
+    case ' ':
+    case '\t':
+    case '\r':
+    case '\n':
+      break;
+
+    case '"':
+      pending_field = -1;
+      token_len = 0;
+      token_overflow = false;
+      state = STATE_STRING;
+      break;
+
+    case ':':
+      // The string just closed was a key
+      if (!token_overflow) {
+        if (strcmp(token, "quote") == 0) {
+          in_quote = true;
+        }
+        pending_field = fieldForKey(token);
+      }
+      break;
+
+    case '[':
+      if (active_field >= 0) {
+        array_depth++;
+      } else if (pending_field >= 0 && !done[pending_field]) {
+        active_field = pending_field;
+        array_depth = 0;
+      }
+      pending_field = -1;
+      break;
+
+    case ']':
+      if (active_field >= 0) {
+        if (array_depth == 0) {
+          done[active_field] = true;
+          active_field = -1;
+        } else {
+          array_depth--;
+        }
+      }
+      break;
+
+    case ',':
+    case '{':
+    case '}':
+      pending_field = -1;
+      break;
+
+    default:
+      pending_field = -1;
+      token_len = 0;
+      token_overflow = false;
+      token[token_len++] = c;
+      state = STATE_LITERAL;
+      break;
+    }
+  }
+
+  bytes_consumed += len;
+  return !failed;
+}
+
+bool ChartStreamParser::isComplete() const {
+  for (int i = 0; i < CHART_FIELD_COUNT; i++) {
+    if (!done[i])
+      return false;
+  }
+  return true;
+}
+
+bool ChartStreamParser::hasAllColumns() const {
+  // Volume may be missing, but not left open
+  for (int i = CHART_FIELD_TIMESTAMP; i <= CHART_FIELD_CLOSE; i++) {
+    if (!done[i])
+      return false;
+  }
+  return active_field < 0;
+}
+
+uint32_t ChartStreamParser::getRowCount() const {
+  // Volume is optional (indices and FX often omit it)
+  uint32_t rows = counts[CHART_FIELD_TIMESTAMP];
+  for (int i = CHART_FIELD_OPEN; i <= CHART_FIELD_CLOSE; i++) {
+    rows = std::min(rows, counts[i]);
+  }
+  return rows;
+}
+
+bool ChartStreamParser::parse(Client &client, uint32_t idle_timeout_ms) {
+  char buf[256];
+  unsigned long last_data = millis();
+  unsigned long start_us = micros();
+  uint32_t feed_cycles = 0;
+
+  while (!isComplete() && !failed) {
+    int avail = client.available();
+    if (avail > 0) {
+      int n = client.read((uint8_t *)buf, std::min((size_t)avail, sizeof(buf)));
+      if (n > 0) {
+        uint32_t feed_start = Metrics::cycles();
+        feed(buf, n);
+        feed_cycles += Metrics::cycles() - feed_start;
+        last_data = millis();
+      }
+    } else if (!client.connected()) {
+      break;
+    } else if (millis() - last_data > idle_timeout_ms) {
+      LOG_W("Chart stream idle timeout");
+      break;
+    } else {
+      delay(1);
+    }
+  }
+
+  // A literal still open here was cut off mid-number; never emit it
+  if (state == STATE_LITERAL) {
+    state = STATE_VALUE;
+    token_len = 0;
+  }
+
+  // Bytes are parsed as they arrive; the rest of the time went to the socket
+  uint32_t parse_us = Metrics::cyclesToUs(feed_cycles);
+  uint32_t elapsed_us = std::max<uint32_t>(micros() - start_us, parse_us);
+  Metrics::record(METRIC_JSON_PARSE, parse_us);
+  Metrics::record(METRIC_BODY_READ, elapsed_us - parse_us);
+
+  // A body that ended or stalled inside a column is a failed load, not a
+  // shorter one: the rows after the cut would never be fetched again
+  return !failed && hasAllColumns() && getRowCount() > 0;
+}
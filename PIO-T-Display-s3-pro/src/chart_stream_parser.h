@@ -0,0 +1,76 @@
+#ifndef CHART_STREAM_PARSER_H
+#define CHART_STREAM_PARSER_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+// Columns we pull out of a Yahoo v8 chart response
+enum ChartField {
+  CHART_FIELD_TIMESTAMP = 0,
+  CHART_FIELD_OPEN,
+  CHART_FIELD_HIGH,
+  CHART_FIELD_LOW,
+  CHART_FIELD_CLOSE,
+  CHART_FIELD_VOLUME,
+  CHART_FIELD_COUNT
+};
+
+// Called once per array element, in order. Null entries arrive as 0.
+typedef void (*ChartValueSink)(ChartField field, uint32_t index, double value,
+                               void *ctx);
+
+// Incremental extractor for `timestamp` and `indicators.quote[0].*` arrays.
+// Works on a byte stream with a fixed amount of state, so the response body
+// and the JSON DOM never have to exist in RAM.
+class ChartStreamParser {
+private:
+  enum State {
+    STATE_VALUE,   // Between tokens
+    STATE_STRING,  // Inside a quoted string
+    STATE_LITERAL, // Inside a number / true / false / null
+  };
+
+  ChartValueSink sink;
+  void *sink_ctx;
+
+  State state;
+  bool escape;
+  bool in_quote;             // Seen the "quote" key
+  int active_field;          // Field whose array we are inside, or -1
+  int pending_field;         // Field named by the last key, or -1
+  int array_depth;           // Nesting depth inside the active array
+  uint32_t counts[CHART_FIELD_COUNT];
+  bool done[CHART_FIELD_COUNT];
+
+  char token[32];
+  uint8_t token_len;
+  bool token_overflow;
+
+  uint32_t bytes_consumed;
+  bool failed;
+
+  void endString();
+  void endLiteral();
+  void emit(double value);
+  int fieldForKey(const char *key) const;
+
+public:
+  ChartStreamParser(ChartValueSink sink, void *ctx);
+
+  void reset();
+  // Feed the next slice of the body; returns false once the input is unusable
+  bool feed(const char *data, size_t len);
+  // Pull from an open connection until all columns are read or it goes idle
+  bool parse(Client &client, uint32_t idle_timeout_ms = 10000);
+
+  bool isComplete() const;
+  // Every price column closed and none left open
+  bool hasAllColumns() const;
+  bool hasFailed() const { return failed; }
+  uint32_t getCount(ChartField field) const { return counts[field]; }
+  // Number of rows present in every column
+  uint32_t getRowCount() const;
+  uint32_t getBytesConsumed() const { return bytes_consumed; }
+};
+
+#endif // CHART_STREAM_PARSER_H
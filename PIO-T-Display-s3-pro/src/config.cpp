@@ -1,7 +1,10 @@
 #include "config.h"
+#include "log.h"
 #include <ArduinoJson.h>
 #include <Preferences.h>
+#include <algorithm>
 #include <lvgl.h>
+#include <nvs.h>
 
 // Default configuration values
 bool USE_TEST_DATA = false;
@@ -17,6 +20,10 @@ String YAHOO_RANGE = "1d";    // Default to 1 day range
 
 // Chart display configuration
 int BARS_TO_SHOW = 50;
+bool USE_CANVAS_RENDERER = false;
+int HISTORY_BARS = DEFAULT_HISTORY_BARS;
+String WATCHLIST = "";
+String DATA_BASE_URL = DEFAULT_DATA_BASE_URL;
 int TEST_DATA_UPDATES_PER_BAR = 10; // Default: 10 updates per bar
 
 // Network configuration - Use your specified defaults
@@ -37,30 +44,91 @@ const int VALID_RANGES_COUNT = sizeof(VALID_RANGES) / sizeof(VALID_RANGES[0]);
 
 Preferences preferences;
 
-void loadConfig() {
-  preferences.begin("stocktracker", true); // read-only mode
+#define CONFIG_NAMESPACE "stocktracker"
+
+typedef enum { CONFIG_BOOL, CONFIG_INT, CONFIG_STRING } config_type_t;
+
+// Every persisted setting. Types match what Preferences stored, so
+// existing NVS contents load unchanged.
+typedef struct {
+  const char *key;
+  config_type_t type;
+  void *value;
+  int int_default; // Bool and int keys
+  const char *string_default;
+} config_key_t;
+
+static const config_key_t CONFIG_KEYS[] = {
+    {"useTestData", CONFIG_BOOL, &USE_TEST_DATA, false, NULL},
+    {"updateInterval", CONFIG_INT, &INTRADAY_UPDATE_INTERVAL, 1000, NULL},
+    {"candleDuration", CONFIG_INT, &CANDLE_COLLECTION_DURATION, 180, NULL},
+    {"symbol", CONFIG_STRING, &STOCK_SYMBOL, 0, "SPY"},
+    {"enforceHours", CONFIG_BOOL, &ENFORCE_MARKET_HOURS, true, NULL},
+    {"yahooInterval", CONFIG_STRING, &YAHOO_INTERVAL, 0, "1m"},
+    {"yahooRange", CONFIG_STRING, &YAHOO_RANGE, 0, "1d"},
+    {"barsToShow", CONFIG_INT, &BARS_TO_SHOW, 50, NULL},
+    {"testUpdatesPerBar", CONFIG_INT, &TEST_DATA_UPDATES_PER_BAR, 10, NULL},
+    {"canvasRender", CONFIG_BOOL, &USE_CANVAS_RENDERER, false, NULL},
+    {"historyBars", CONFIG_INT, &HISTORY_BARS, DEFAULT_HISTORY_BARS, NULL},
+    {"watchlist", CONFIG_STRING, &WATCHLIST, 0, ""},
+    {"dataBaseUrl", CONFIG_STRING, &DATA_BASE_URL, 0, DEFAULT_DATA_BASE_URL},
+    {"useStaticIP", CONFIG_BOOL, &USE_STATIC_IP, false, NULL},
+    {"staticIP", CONFIG_STRING, &STATIC_IP, 0, "192.168.4.184"},
+    {"gatewayIP", CONFIG_STRING, &GATEWAY_IP, 0, "192.168.4.1"},
+    {"subnetMask", CONFIG_STRING, &SUBNET_MASK, 0, "255.255.255.0"},
+};
+static const int CONFIG_KEY_COUNT = sizeof(CONFIG_KEYS) / sizeof(CONFIG_KEYS[0]);
+
+// What NVS holds for each key, as text, so a save writes only the keys
+// whose current value differs
+static String persisted[CONFIG_KEY_COUNT];
+
+static unsigned long save_requested = 0; // First saveConfig() of a burst
+static unsigned long save_due = 0;
+static bool save_pending = false;
+static config_save_stats_t save_stats = {0};
+
+static String configValueText(const config_key_t &entry) {
+  switch (entry.type) {
+  case CONFIG_BOOL:
+    return *(bool *)entry.value ? "1" : "0";
+  case CONFIG_INT:
+    return String(*(int *)entry.value);
+  default:
+    return *(String *)entry.value;
+  }
+}
 
-  USE_TEST_DATA = preferences.getBool("useTestData", false);
-  USE_INTRADAY_DATA = true; // Always enable for real-time updates
-  INTRADAY_UPDATE_INTERVAL =
-      preferences.getInt("updateInterval", 1000); // Now in milliseconds
-  CANDLE_COLLECTION_DURATION = preferences.getInt("candleDuration", 180);
-  STOCK_SYMBOL = preferences.getString("symbol", "SPY");
-  ENFORCE_MARKET_HOURS = preferences.getBool("enforceHours", true);
-  YAHOO_INTERVAL = preferences.getString("yahooInterval", "1m");
-  YAHOO_RANGE = preferences.getString("yahooRange", "1d");
-  BARS_TO_SHOW =
-      preferences.getInt("barsToShow", 50); // Load potentially invalid value
-  TEST_DATA_UPDATES_PER_BAR = preferences.getInt("testUpdatesPerBar", 10);
-
-  // Network configuration with your defaults
-  USE_STATIC_IP = preferences.getBool("useStaticIP", false);
-  STATIC_IP = preferences.getString("staticIP", "192.168.4.184");
-  GATEWAY_IP = preferences.getString("gatewayIP", "192.168.4.1");
-  SUBNET_MASK = preferences.getString("subnetMask", "255.255.255.0");
+void loadConfig() {
+  preferences.begin(CONFIG_NAMESPACE, true); // read-only mode
+
+  for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+    const config_key_t &entry = CONFIG_KEYS[i];
+    switch (entry.type) {
+    case CONFIG_BOOL:
+      *(bool *)entry.value = preferences.getBool(entry.key, entry.int_default);
+      break;
+    case CONFIG_INT:
+      *(int *)entry.value = preferences.getInt(entry.key, entry.int_default);
+      break;
+    default:
+      *(String *)entry.value =
+          preferences.getString(entry.key, entry.string_default);
+      break;
+    }
+    persisted[i] = configValueText(entry);
+  }
 
   preferences.end();
 
+  USE_INTRADAY_DATA = true; // Always enable for real-time updates
+  HISTORY_BARS = constrain(HISTORY_BARS, MIN_HISTORY_BARS, MAX_HISTORY_BARS);
+  WATCHLIST = normalizeWatchlist(WATCHLIST);
+  DATA_BASE_URL = normalizeBaseUrl(DATA_BASE_URL);
+  if (DATA_BASE_URL.isEmpty()) {
+    DATA_BASE_URL = DEFAULT_DATA_BASE_URL;
+  }
+
   // Validate loaded values
   if (!validateInterval(YAHOO_INTERVAL)) {
     YAHOO_INTERVAL = "1m";
@@ -80,84 +148,122 @@ void loadConfig() {
   syncCandleDurationWithInterval();
 
   // FIXED: Validate bars to show using calculateMaxBars
-  Serial.println("Validating BARS_TO_SHOW...");
-  Serial.println("Loaded BARS_TO_SHOW from preferences: " +
-                 String(BARS_TO_SHOW));
-
   int actualScreenWidth = getScreenWidth();
-  Serial.println("Screen width: " + String(actualScreenWidth));
-
-  // This should trigger the calculateMaxBars debug output
   int maxBars = calculateMaxBars(actualScreenWidth, INFO_PANEL_WIDTH, 1);
-  Serial.println("calculateMaxBars returned: " + String(maxBars));
 
   if (BARS_TO_SHOW < 1 || BARS_TO_SHOW > maxBars) {
     int oldValue = BARS_TO_SHOW;
     BARS_TO_SHOW = std::min(
         50, maxBars); // Default to 50 or max allowed, whichever is smaller
-    Serial.println("BARS_TO_SHOW was out of range (" + String(oldValue) +
-                   "), adjusted to: " + String(BARS_TO_SHOW));
-    Serial.println("Maximum allowed: " + String(maxBars));
-
-    // Save the corrected value back to preferences
-    preferences.begin("stocktracker", false);
-    preferences.putInt("barsToShow", BARS_TO_SHOW);
-    preferences.end();
-    Serial.println("Saved corrected BARS_TO_SHOW to preferences");
-  } else {
-    Serial.println("BARS_TO_SHOW is valid: " + String(BARS_TO_SHOW) +
-                   " (max: " + String(maxBars) + ")");
-  }
-
-  // DEBUG: Print the actual stored values
-  Serial.println("\n=== CONFIGURATION LOADED ===");
-  Serial.println("Symbol: " + STOCK_SYMBOL);
-  Serial.println("Interval: " + YAHOO_INTERVAL);
-  Serial.println("Range: " + YAHOO_RANGE);
-  Serial.println("UPDATE INTERVAL (ms): " + String(INTRADAY_UPDATE_INTERVAL));
-  Serial.println("TEST UPDATES PER BAR: " + String(TEST_DATA_UPDATES_PER_BAR));
-  Serial.println("Use Test Data: " + String(USE_TEST_DATA));
-  Serial.println("Auto-synced candle duration: " +
-                 String(CANDLE_COLLECTION_DURATION) + " seconds");
-  Serial.println("BARS_TO_SHOW: " + String(BARS_TO_SHOW) + " (validated)");
-  Serial.println("Screen width: " + String(actualScreenWidth));
-  Serial.println("Use Intraday: " + String(USE_INTRADAY_DATA) +
-                 " (always enabled)");
-  Serial.println("Network - Use Static IP: " + String(USE_STATIC_IP));
-  if (USE_STATIC_IP) {
-    Serial.println("Static IP: " + STATIC_IP);
-    Serial.println("Gateway: " + GATEWAY_IP);
-    Serial.println("Subnet: " + SUBNET_MASK);
-  }
-  Serial.println("============================\n");
+    // Written back with any other corrections at the end
+    LOG_W("BARS_TO_SHOW was out of range (%d), adjusted to %d (max %d)",
+          oldValue, BARS_TO_SHOW, maxBars);
+  }
+
+  LOG_I("Config: %s %s/%s, %d of %d bars shown, %d px wide, %s data from %s",
+        STOCK_SYMBOL.c_str(), YAHOO_INTERVAL.c_str(), YAHOO_RANGE.c_str(),
+        BARS_TO_SHOW, maxBars, actualScreenWidth,
+        USE_TEST_DATA ? "test" : "real", DATA_BASE_URL.c_str());
+  LOG_D("Config: update every %d ms, %d test updates per bar, %d s candles, "
+        "%s",
+        INTRADAY_UPDATE_INTERVAL, TEST_DATA_UPDATES_PER_BAR,
+        CANDLE_COLLECTION_DURATION, USE_STATIC_IP ? "static IP" : "DHCP");
 
   // Call the bar limitations debug function
   printBarLimitations();
+
+  // Persists whatever validation corrected; a no-op when nothing did
+  saveConfig();
 }
 
 void saveConfig() {
-  preferences.begin("stocktracker", false); // read-write mode
-
-  preferences.putBool("useTestData", USE_TEST_DATA);
-  preferences.putBool("useIntraday", USE_INTRADAY_DATA);
-  preferences.putInt("updateInterval", INTRADAY_UPDATE_INTERVAL);
-  preferences.putInt("candleDuration", CANDLE_COLLECTION_DURATION);
-  preferences.putString("symbol", STOCK_SYMBOL);
-  preferences.putBool("enforceHours", ENFORCE_MARKET_HOURS);
-  preferences.putString("yahooInterval", YAHOO_INTERVAL);
-  preferences.putString("yahooRange", YAHOO_RANGE);
-  preferences.putInt("barsToShow", BARS_TO_SHOW);
-  preferences.putInt("testUpdatesPerBar", TEST_DATA_UPDATES_PER_BAR); // NEW
-  preferences.putBool("useStaticIP", USE_STATIC_IP);
-  preferences.putString("staticIP", STATIC_IP);
-  preferences.putString("gatewayIP", GATEWAY_IP);
-  preferences.putString("subnetMask", SUBNET_MASK);
+  // Edits arriving in a burst share one write, but a steady stream of
+  // them cannot hold the write off forever
+  unsigned long now = millis();
+  if (!save_pending) {
+    save_pending = true;
+    save_requested = now;
+  }
+  save_due = now + CONFIG_SAVE_DEBOUNCE_MS;
+  if (save_due - save_requested > CONFIG_SAVE_MAX_DELAY_MS) {
+    save_due = save_requested + CONFIG_SAVE_MAX_DELAY_MS;
+  }
+}
 
-  preferences.end();
+void serviceConfigSave() {
+  if (save_pending && (long)(millis() - save_due) >= 0) {
+    flushConfig();
+  }
+}
+
+void flushConfig() {
+  save_pending = false;
+
+  int dirty = 0;
+  for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+    if (configValueText(CONFIG_KEYS[i]) != persisted[i]) {
+      dirty++;
+    }
+  }
+  if (dirty == 0) {
+    return;
+  }
+
+  // Raw NVS so every changed key lands in a single commit; Preferences
+  // commits after each put
+  unsigned long start = micros();
+  nvs_handle_t handle;
+  esp_err_t err = nvs_open(CONFIG_NAMESPACE, NVS_READWRITE, &handle);
+  if (err != ESP_OK) {
+    LOG_E("Config save failed to open NVS: %s", esp_err_to_name(err));
+    return;
+  }
+
+  for (int i = 0; i < CONFIG_KEY_COUNT && err == ESP_OK; i++) {
+    const config_key_t &entry = CONFIG_KEYS[i];
+    String text = configValueText(entry);
+    if (text == persisted[i]) {
+      continue;
+    }
 
-  Serial.println("Configuration saved");
+    switch (entry.type) {
+    case CONFIG_BOOL:
+      err = nvs_set_u8(handle, entry.key, *(bool *)entry.value);
+      break;
+    case CONFIG_INT:
+      err = nvs_set_i32(handle, entry.key, *(int *)entry.value);
+      break;
+    default:
+      err = nvs_set_str(handle, entry.key, text.c_str());
+      break;
+    }
+    if (err == ESP_OK) {
+      persisted[i] = text;
+      save_stats.keys_written++;
+    }
+  }
+  if (err == ESP_OK) {
+    err = nvs_commit(handle);
+  }
+  nvs_close(handle);
+
+  uint32_t elapsed_us = micros() - start;
+  save_stats.saves++;
+  save_stats.last_us = elapsed_us;
+  save_stats.max_us = std::max(save_stats.max_us, elapsed_us);
+
+  if (err != ESP_OK) {
+    // Unwritten keys stay dirty and go out with the next save
+    save_stats.failures++;
+    LOG_E("Config save failed: %s", esp_err_to_name(err));
+    return;
+  }
+  LOG_I("Configuration saved: %d of %d keys in %u us", dirty,
+        CONFIG_KEY_COUNT, elapsed_us);
 }
 
+const config_save_stats_t &getConfigSaveStats() { return save_stats; }
+
 bool validateSymbol(const String &symbol) {
   // Basic validation for stock symbols
   if (symbol.length() == 0 || symbol.length() > 8) {
@@ -179,6 +285,61 @@ bool validateSymbol(const String &symbol) {
   return hasLetter;
 }
 
+String normalizeWatchlist(const String &list) {
+  // Uppercase, drop invalid and repeated symbols, cap the count
+  String normalized = "";
+  int count = 0;
+  int start = 0;
+
+  while (start <= (int)list.length() && count < WATCHLIST_MAX_SYMBOLS) {
+    int end = list.indexOf(',', start);
+    if (end < 0) {
+      end = list.length();
+    }
+
+    String symbol = list.substring(start, end);
+    symbol.trim();
+    symbol.toUpperCase();
+    start = end + 1;
+
+    if (!validateSymbol(symbol) ||
+        ("," + normalized + ",").indexOf("," + symbol + ",") >= 0) {
+      continue;
+    }
+    if (normalized.length() > 0) {
+      normalized += ",";
+    }
+    normalized += symbol;
+    count++;
+  }
+  return normalized;
+}
+
+String normalizeBaseUrl(const String &url) {
+  // Requests append "/v8/..." paths, so only scheme, host and port are kept
+  String base = url;
+  base.trim();
+  while (base.endsWith("/")) {
+    base.remove(base.length() - 1);
+  }
+
+  int host_start = base.startsWith("https://") ? 8
+                   : base.startsWith("http://") ? 7
+                                                : -1;
+  if (host_start < 0 || (int)base.length() <= host_start ||
+      base.length() >= DATA_BASE_URL_CHARS ||
+      base.indexOf('/', host_start) >= 0) {
+    return "";
+  }
+  for (int i = host_start; i < (int)base.length(); i++) {
+    char c = base.charAt(i);
+    if (!isalnum(c) && c != '.' && c != '-' && c != ':') {
+      return "";
+    }
+  }
+  return base;
+}
+
 bool validateInterval(const String &interval) {
   for (int i = 0; i < VALID_INTERVALS_COUNT; i++) {
     if (interval == VALID_INTERVALS[i]) {
@@ -224,19 +385,11 @@ bool validateIP(const String &ip) {
 }
 
 int calculateMaxBars(int screenWidth, int panelWidth, int candleMinWidth) {
-  Serial.println("\n=== calculateMaxBars() DEBUG ===");
-  Serial.println("Input parameters:");
-  Serial.println("  screenWidth: " + String(screenWidth));
-  Serial.println("  panelWidth: " + String(panelWidth));
-  Serial.println("  candleMinWidth: " + String(candleMinWidth));
-
   int chartWidth = screenWidth - panelWidth;
-  Serial.println("  chartWidth: " + String(chartWidth));
 
   // Calculate maximum bars based on screen resolution
   int maxBarsScreen;
   int padding = CANDLE_PADDING;
-  Serial.println("  CANDLE_PADDING: " + String(padding));
 
   if (padding == 0) {
     // Simple case: no padding, just divide available width by minimum candle
@@ -247,8 +400,8 @@ int calculateMaxBars(int screenWidth, int panelWidth, int candleMinWidth) {
     maxBarsScreen = (chartWidth + padding) / (candleMinWidth + padding);
   }
 
-  // UPDATED: Limit by data buffer size - can only show MAX_CANDLES - 5
-  int maxBarsData = MAX_CANDLES - 5; // Reserve 5 slots for buffer management
+  // UPDATED: Limit by data buffer size - can only show HISTORY_BARS - 5
+  int maxBarsData = HISTORY_BARS - 5; // Reserve 5 slots for buffer management
 
   // Use the smaller of screen limitation or data limitation
   int actualMaxBars = std::min(maxBarsScreen, maxBarsData);
@@ -257,12 +410,7 @@ int calculateMaxBars(int screenWidth, int panelWidth, int candleMinWidth) {
   actualMaxBars = std::max(5, actualMaxBars);           // Minimum of 5 bars
   actualMaxBars = std::min(actualMaxBars, maxBarsData); // Cap at data limit
 
-  Serial.println("Calculations:");
-  Serial.println("  maxBarsScreen: " + String(maxBarsScreen));
-  Serial.println("  maxBarsData: " + String(maxBarsData) +
-                 " (MAX_CANDLES - 5)");
-  Serial.println("  actualMaxBars: " + String(actualMaxBars));
-
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
   // Additional debug: show what the actual candle width would be
   int actual_candle_width;
   if (padding == 0) {
@@ -271,9 +419,11 @@ int calculateMaxBars(int screenWidth, int panelWidth, int candleMinWidth) {
     int total_padding_space = (actualMaxBars - 1) * padding;
     actual_candle_width = (chartWidth - total_padding_space) / actualMaxBars;
   }
-  Serial.println("  actual_candle_width at max bars: " +
-                 String(actual_candle_width));
-  Serial.println("================================\n");
+  LOG_D("calculateMaxBars: chart %d px, padding %d, screen max %d, data max "
+        "%d, %d px candles at %d bars",
+        chartWidth, padding, maxBarsScreen, maxBarsData, actual_candle_width,
+        actualMaxBars);
+#endif
 
   int renderingBuffer = 5; // "minus 5" for reasons due to padding and rounding
   int bufferedMax = actualMaxBars - renderingBuffer;
@@ -281,11 +431,6 @@ int calculateMaxBars(int screenWidth, int panelWidth, int candleMinWidth) {
   // Ensure we don't go below minimum
   bufferedMax = std::max(5, bufferedMax);
 
-  Serial.println("Applied rendering buffer:");
-  Serial.println("  theoretical_max: " + String(actualMaxBars));
-  Serial.println("  rendering_buffer: " + String(renderingBuffer));
-  Serial.println("  final_max: " + String(bufferedMax));
-
   return bufferedMax;
 }
 
@@ -326,14 +471,13 @@ void syncCandleDurationWithInterval() {
     intervalSeconds = 7776000; // 90 days (approx)
   else {
     // For unsupported intervals, default to 5 minutes
-    Serial.println("Warning: Unsupported interval, defaulting to 5 minutes");
+    LOG_W("Unsupported interval, defaulting to 5 minutes");
     intervalSeconds = 300;
   }
 
   if (intervalSeconds != CANDLE_COLLECTION_DURATION) {
-    Serial.printf("Auto-syncing candle duration: %d -> %d seconds (%s)\n",
-                  CANDLE_COLLECTION_DURATION, intervalSeconds,
-                  YAHOO_INTERVAL.c_str());
+    LOG_D("Auto-syncing candle duration: %d -> %d seconds (%s)",
+          CANDLE_COLLECTION_DURATION, intervalSeconds, YAHOO_INTERVAL.c_str());
     CANDLE_COLLECTION_DURATION = intervalSeconds;
   }
 }
@@ -343,7 +487,7 @@ bool setConfigFromJSON(const String &json) {
   DeserializationError error = deserializeJson(doc, json);
 
   if (error) {
-    Serial.println("Failed to parse JSON config");
+    LOG_W("Failed to parse JSON config");
     return false;
   }
 
@@ -354,15 +498,10 @@ bool setConfigFromJSON(const String &json) {
 
   // Always enable intraday data for real-time updates
   USE_INTRADAY_DATA = true;
-  Serial.println("Intraday data always enabled for real-time updates");
 
   if (doc["updateInterval"].is<int>()) {
-    int newInterval = doc["updateInterval"];
-    Serial.println("JSON updateInterval received: " + String(newInterval) +
-                   "ms");
-    INTRADAY_UPDATE_INTERVAL = newInterval;
-    Serial.println("INTRADAY_UPDATE_INTERVAL set to: " +
-                   String(INTRADAY_UPDATE_INTERVAL) + "ms");
+    INTRADAY_UPDATE_INTERVAL = doc["updateInterval"];
+    LOG_D("Update interval set to: %d ms", INTRADAY_UPDATE_INTERVAL);
   }
 
   // NEW: Handle test data updates per bar
@@ -370,11 +509,10 @@ bool setConfigFromJSON(const String &json) {
     int updatesPerBar = doc["testUpdatesPerBar"];
     if (updatesPerBar >= 1 && updatesPerBar <= 1000) {
       TEST_DATA_UPDATES_PER_BAR = updatesPerBar;
-      Serial.println("Test updates per bar set to: " +
-                     String(TEST_DATA_UPDATES_PER_BAR));
+      LOG_D("Test updates per bar set to: %d", TEST_DATA_UPDATES_PER_BAR);
     } else {
-      Serial.println("Invalid test updates per bar value, keeping current: " +
-                     String(TEST_DATA_UPDATES_PER_BAR));
+      LOG_W("Invalid test updates per bar value, keeping current: %d",
+            TEST_DATA_UPDATES_PER_BAR);
     }
   }
 
@@ -383,21 +521,45 @@ bool setConfigFromJSON(const String &json) {
     symbol.toUpperCase();
     if (validateSymbol(symbol)) {
       STOCK_SYMBOL = symbol;
-      Serial.println("Symbol updated to: " + STOCK_SYMBOL);
+      LOG_D("Symbol updated to: %s", STOCK_SYMBOL.c_str());
     } else {
-      Serial.println("Invalid symbol rejected: " + symbol);
+      LOG_W("Invalid symbol rejected: %s", symbol.c_str());
     }
   }
   if (doc["enforceHours"].is<bool>()) {
     ENFORCE_MARKET_HOURS = doc["enforceHours"];
   }
+  if (doc["canvasRenderer"].is<bool>()) {
+    USE_CANVAS_RENDERER = doc["canvasRenderer"];
+  }
+  if (doc["watchlist"].is<String>()) {
+    WATCHLIST = normalizeWatchlist(doc["watchlist"].as<String>());
+    LOG_D("Watchlist set to: %s", WATCHLIST.c_str());
+  }
+  if (doc["dataBaseUrl"].is<String>()) {
+    String url = doc["dataBaseUrl"].as<String>();
+    // Clearing the field goes back to Yahoo
+    String base =
+        normalizeBaseUrl(url.isEmpty() ? String(DEFAULT_DATA_BASE_URL) : url);
+    if (!base.isEmpty()) {
+      DATA_BASE_URL = base;
+      LOG_D("Data source set to: %s", DATA_BASE_URL.c_str());
+    } else {
+      LOG_W("Invalid data source URL rejected: %s", url.c_str());
+    }
+  }
+  if (doc["historyBars"].is<int>()) {
+    HISTORY_BARS = constrain(doc["historyBars"].as<int>(), MIN_HISTORY_BARS,
+                             MAX_HISTORY_BARS);
+    LOG_D("History bars set to: %d", HISTORY_BARS);
+  }
   if (doc["yahooInterval"].is<String>()) {
     String interval = doc["yahooInterval"].as<String>();
     if (validateInterval(interval)) {
       YAHOO_INTERVAL = interval;
       syncCandleDurationWithInterval();
-      Serial.printf("Interval updated to: %s (duration: %d seconds)\n",
-                    YAHOO_INTERVAL.c_str(), CANDLE_COLLECTION_DURATION);
+      LOG_D("Interval updated to: %s (duration: %d seconds)",
+            YAHOO_INTERVAL.c_str(), CANDLE_COLLECTION_DURATION);
     }
   }
   if (doc["yahooRange"].is<String>()) {
@@ -414,15 +576,15 @@ bool setConfigFromJSON(const String &json) {
 
     if (bars >= 1 && bars <= maxBarsAllowed) {
       BARS_TO_SHOW = bars;
-      Serial.printf("Bars to show set to: %d (max allowed: %d)\n", BARS_TO_SHOW,
-                    maxBarsAllowed);
+      LOG_D("Bars to show set to: %d (max allowed: %d)", BARS_TO_SHOW,
+            maxBarsAllowed);
     } else {
       // Clamp to valid range
       BARS_TO_SHOW = std::min(bars, maxBarsAllowed);
       BARS_TO_SHOW = std::max(BARS_TO_SHOW, 1);
-      Serial.printf("Bars clamped from %d to %d (max allowed: %d, limited by "
-                    "data buffer)\n",
-                    bars, BARS_TO_SHOW, maxBarsAllowed);
+      LOG_W("Bars clamped from %d to %d (max allowed: %d, limited by data "
+            "buffer)",
+            bars, BARS_TO_SHOW, maxBarsAllowed);
     }
     printBarLimitations();
   }
@@ -465,11 +627,18 @@ String getConfigJSON() {
   doc["yahooRange"] = YAHOO_RANGE;
   doc["barsToShow"] = BARS_TO_SHOW;
   doc["testUpdatesPerBar"] = TEST_DATA_UPDATES_PER_BAR;
+  doc["canvasRenderer"] = USE_CANVAS_RENDERER;
+  doc["historyBars"] = HISTORY_BARS;
+  doc["watchlist"] = WATCHLIST;
+  doc["dataBaseUrl"] = DATA_BASE_URL;
+  doc["maxWatchlist"] = WATCHLIST_MAX_SYMBOLS;
+  doc["minHistoryBars"] = MIN_HISTORY_BARS;
+  doc["maxHistoryBars"] = MAX_HISTORY_BARS;
 
   // Add computed candle duration for display purposes (read-only)
   doc["computedCandleDuration"] = CANDLE_COLLECTION_DURATION;
 
-  // Calculate maximum bars - this function now handles MAX_CANDLES - 5
+  // Calculate maximum bars - this function now handles HISTORY_BARS - 5
   // internally
   int actualScreenWidth = getScreenWidth();
   int maxBarsAllowed = calculateMaxBars(actualScreenWidth, INFO_PANEL_WIDTH, 1);
@@ -481,7 +650,7 @@ String getConfigJSON() {
   // Optional debug info (you can keep or remove these)
   doc["maxBarsScreen"] =
       (actualScreenWidth - INFO_PANEL_WIDTH); // Raw screen capacity
-  doc["maxBarsData"] = MAX_CANDLES - 5;       // Data buffer limitation
+  doc["maxBarsData"] = HISTORY_BARS - 5;      // Data buffer limitation
 
   doc["useStaticIP"] = USE_STATIC_IP;
   doc["staticIP"] = STATIC_IP;
@@ -505,22 +674,17 @@ String getConfigJSON() {
 }
 
 void printBarLimitations() {
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
   int screenWidth = getScreenWidth();
   int chartWidth = screenWidth - INFO_PANEL_WIDTH;
   int maxBarsScreen = chartWidth / 1; // Minimum 1-pixel candles
-  int maxBarsData = MAX_CANDLES - 5;
+  int maxBarsData = HISTORY_BARS - 5;
   int actualMax = std::min(maxBarsScreen, maxBarsData);
 
-  Serial.println("=== BAR DISPLAY LIMITATIONS ===");
-  Serial.println("Screen width: " + String(screenWidth));
-  Serial.println("Chart width: " + String(chartWidth));
-  Serial.println("Theoretical max (1px candles): " + String(maxBarsScreen));
-  Serial.println("Data buffer limit: " + String(maxBarsData) +
-                 " (MAX_CANDLES - 5)");
-  Serial.println("Actual maximum bars: " + String(actualMax));
-  Serial.println("Current BARS_TO_SHOW: " + String(BARS_TO_SHOW));
-  Serial.println("Limiting factor: " + String(actualMax == maxBarsScreen
-                                                  ? "Screen resolution"
-                                                  : "Data buffer"));
-  Serial.println("===============================");
+  LOG_D("Bar limits: screen %d px, chart %d px, %d bars at 1 px, data "
+        "buffer %d, max %d (limited by %s), showing %d",
+        screenWidth, chartWidth, maxBarsScreen, maxBarsData, actualMax,
+        actualMax == maxBarsScreen ? "screen resolution" : "data buffer",
+        BARS_TO_SHOW);
+#endif
 }
\ No newline at end of file
@@ -4,9 +4,17 @@
 #include <Arduino.h>
 
 #define TIME_ZONE "PST8PDT" // Set to the desired time zone
-#define MAX_CANDLES 500     // Define this as a constant
+#define DEFAULT_DATA_BASE_URL "https://query1.finance.yahoo.com"
+#define DATA_BASE_URL_CHARS 64 // Scheme, host and optional port
+#define DEFAULT_HISTORY_BARS 2000 // Bars kept in the PSRAM candle store
+#define MIN_HISTORY_BARS 100
+#define MAX_HISTORY_BARS 50000
+#define WATCHLIST_MAX_SYMBOLS 8
+#define WATCHLIST_CHARS (WATCHLIST_MAX_SYMBOLS * 9) // "SYMBOL,"... + NUL
 #define INFO_PANEL_WIDTH 80
 #define CANDLE_PADDING 0
+#define CONFIG_SAVE_DEBOUNCE_MS 2000 // Quiet time before edits are written
+#define CONFIG_SAVE_MAX_DELAY_MS 10000
 
 // Stock data configuration
 extern bool USE_TEST_DATA;
@@ -25,6 +33,10 @@ extern String YAHOO_RANGE; // 1d, 5d, 1mo, 3mo, 6mo, 1y, 2y, 5y, 10y, ytd, max
 
 // Chart display configuration
 extern int BARS_TO_SHOW; // Added missing declaration
+extern bool USE_CANVAS_RENDERER; // Rasterize candles into one canvas
+extern int HISTORY_BARS;         // Candle store capacity
+extern String WATCHLIST;         // Comma-separated symbols quoted in batch
+extern String DATA_BASE_URL;     // Yahoo, or a plain-HTTP stand-in
 
 // Valid options for dropdowns (symbols removed - now free text input)
 extern const char *VALID_INTERVALS[];
@@ -38,13 +50,28 @@ extern String STATIC_IP;
 extern String GATEWAY_IP;
 extern String SUBNET_MASK;
 
+typedef struct {
+  uint32_t saves;        // NVS commits
+  uint32_t keys_written; // Keys that actually changed
+  uint32_t failures;
+  uint32_t last_us;
+  uint32_t max_us;
+} config_save_stats_t;
+
 // Function to load configuration
 void loadConfig();
+// Marks the config for saving; the write happens in serviceConfigSave()
+// once edits stop, and only changed keys are written
 void saveConfig();
+void serviceConfigSave();
+void flushConfig(); // Writes pending changes now
+const config_save_stats_t &getConfigSaveStats();
 void syncCandleDurationWithInterval(); // NEW: Auto-sync function
 bool validateInterval(const String &interval);
 bool validateRange(const String &range);
 bool validateSymbol(const String &symbol);
+String normalizeWatchlist(const String &list);
+String normalizeBaseUrl(const String &url); // Empty if unusable
 bool validateIP(const String &ip);
 int calculateMaxBars(int screenWidth, int panelWidth = 80,
                      int candleMinWidth = 1);
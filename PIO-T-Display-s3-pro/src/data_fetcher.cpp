@@ -1,178 +1,413 @@
 #include "data_fetcher.h"
+#include "candle_snapshot.h"
+#include "fetch_task.h"
+#include "http_session.h"
+#include "log.h"
 #include "market_hours.h"
+#include "watchlist.h"
 #include <algorithm>
 
 // Static member definitions
-enhanced_candle_t DataFetcher::candles[MAX_CANDLES];
-int DataFetcher::newest_candle_index = -1;
-int DataFetcher::num_candles = 0;
+CandleStore DataFetcher::store;
+CandleStore DataFetcher::view;
+int DataFetcher::view_seconds = 0;
+bool DataFetcher::view_stale = false;
 time_t DataFetcher::last_update_time = 0;
 float DataFetcher::current_price = 0.0;
 bool DataFetcher::initial_data_loaded = false;
 String DataFetcher::current_symbol = "";
 String DataFetcher::current_interval = "";
 String DataFetcher::current_range = "";
+uint32_t DataFetcher::load_generation = 0;
+bool DataFetcher::store_live = false;
+enhanced_candle_t *DataFetcher::fetch_candles = NULL;
+int DataFetcher::fetch_capacity = 0;
+enhanced_candle_t DataFetcher::poll_batch[POLL_MAX_BARS];
+time_t DataFetcher::fetch_newest_timestamp = 0;
 
 bool DataFetcher::initialize(const String &symbol) {
   // Always reset first to ensure clean state
   reset();
 
+  if (store.capacity() != HISTORY_BARS && !allocateStore(HISTORY_BARS)) {
+    return false;
+  }
+
   current_symbol = symbol;
   current_interval = YAHOO_INTERVAL;
   current_range = YAHOO_RANGE;
+  view_seconds = 0;
+  store_live = !USE_TEST_DATA;
+  time_t resume_from = 0;
+
+  // Coarse intervals are folded locally from 1m bars where the range allows,
+  // so later interval switches need no refetch. The last snapshot is shown
+  // straight away while the network catches up.
+  if (!USE_TEST_DATA) {
+    current_interval = fetchIntervalFor(YAHOO_INTERVAL, YAHOO_RANGE);
+    resume_from = restoreSnapshot();
+    if (!selectView(YAHOO_INTERVAL)) {
+      // Drop the 1m bars restored above; a miss below leaves nothing shown
+      reset();
+      current_interval = YAHOO_INTERVAL;
+      resume_from = restoreSnapshot();
+    }
+  }
+
+  // Batches still queued for an earlier request are dropped by generation
+  load_generation++;
 
-  Serial.println("Initializing DataFetcher for symbol: " + symbol);
-  Serial.println("Use test data: " + String(USE_TEST_DATA));
+  LOG_I("Initializing DataFetcher for %s (%s data)", symbol.c_str(),
+        USE_TEST_DATA ? "test" : "real");
 
   if (USE_TEST_DATA) {
-    Serial.println("Using test data mode");
     initializeTestData();
     return true;
   } else {
-    Serial.println("Using real data mode");
-    // Fetch initial historical data
-    return fetchInitialData(symbol, YAHOO_INTERVAL, YAHOO_RANGE);
+    // The fetch task loads history and streams batches back
+    FetchTask::requestLoad(load_generation, symbol, current_interval,
+                           YAHOO_RANGE, store.capacity(), resume_from);
+    return true;
   }
 }
 
-bool DataFetcher::fetchInitialData(const String &symbol, const String &interval,
-                                   const String &range) {
-  Serial.println("Fetching initial data for " + symbol +
-                 " with interval=" + interval + " range=" + range);
+time_t DataFetcher::restoreSnapshot() {
+  time_t newest = CandleSnapshot::load(current_symbol, current_interval, store);
+  if (newest > 0) {
+    current_price = store.close(0);
+    initial_data_loaded = true;
+  }
+  return newest;
+}
 
-  HTTPClient http;
-  String url = "https://query1.finance.yahoo.com/v8/finance/chart/" + symbol +
-               "?interval=" + interval + "&range=" + range;
+void DataFetcher::saveSnapshot() {
+  if (store_live) {
+    CandleSnapshot::checkpoint(current_symbol, current_interval, store, true);
+  }
+}
 
-  Serial.println("URL: " + url);
-  http.begin(url);
-  http.setTimeout(10000); // 10 second timeout
+String DataFetcher::fetchIntervalFor(const String &interval,
+                                     const String &range) {
+  // Yahoo only serves 1m bars for recent sessions; use them when the whole
+  // range fits in the store
+  int sessions = (range == "1d") ? 1 : (range == "5d") ? 5 : 0;
+  int session_bars = (StockTracker::MARKET_CLOSE_HOUR * 60 +
+                      StockTracker::MARKET_CLOSE_MINUTE) -
+                     (StockTracker::MARKET_OPEN_HOUR * 60 +
+                      StockTracker::MARKET_OPEN_MINUTE);
+
+  if (sessions > 0 && store.capacity() >= sessions * session_bars &&
+      CandleResampler::canResample(60,
+                                   CandleResampler::bucketSeconds(interval))) {
+    return "1m";
+  }
+  return interval;
+}
 
-  int httpCode = http.GET();
-  if (httpCode != HTTP_CODE_OK) {
-    Serial.println("HTTP request failed with code: " + String(httpCode));
-    http.end();
+bool DataFetcher::selectView(const String &interval) {
+  if (interval == current_interval) {
+    view_seconds = 0;
+    view.clear();
+    return true;
+  }
+
+  int base_seconds = CandleResampler::bucketSeconds(current_interval);
+  int seconds = CandleResampler::bucketSeconds(interval);
+  if (!CandleResampler::canResample(base_seconds, seconds)) {
     return false;
   }
 
-  String payload = http.getString();
-  int payloadSize = payload.length();
-  Serial.println("Response size: " + String(payloadSize) + " bytes");
+  // Never more buckets than bars, so the view matches the store's size
+  if (view.capacity() != store.capacity() && !view.allocate(store.capacity())) {
+    LOG_W("Not enough PSRAM for a resampled view");
+    return false;
+  }
 
-  http.end();
+  unsigned long start_us = micros();
+  view_seconds = seconds;
+  CandleResampler::rebuild(store, base_seconds, view, seconds);
+  LOG_I("Resampled %d x %s bars into %d x %s in %lu us", store.size(),
+        current_interval.c_str(), view.size(), interval.c_str(),
+        micros() - start_us);
+  return true;
+}
 
-  // Check if payload is too large for ESP32 to handle
-  if (payloadSize > 50000) { // 50KB limit
-    Serial.println("Response too large (" + String(payloadSize) +
-                   " bytes), trying smaller range...");
+bool DataFetcher::switchInterval(const String &interval) {
+  if (USE_TEST_DATA || current_interval.length() == 0) {
+    return false;
+  }
+  return selectView(interval);
+}
 
-    // Try with a smaller range
-    String smallerRange = getSmallerRange(range);
-    if (smallerRange != range) {
-      Serial.println("Retrying with smaller range: " + smallerRange);
-      return fetchInitialData(symbol, interval, smallerRange);
-    } else {
-      Serial.println("Cannot reduce range further, using fallback");
-      return fetchFallbackData(symbol);
-    }
+bool DataFetcher::allocateStore(int capacity) {
+  if (store.allocate(capacity)) {
+    LOG_I("Candle store: %d bars in PSRAM, %u bytes/bar", capacity,
+          (unsigned)store.bytesPerBar());
+    return true;
   }
 
-  // Use standard JsonDocument with automatic sizing
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, payload);
-  if (error) {
-    Serial.println("JSON parsing failed: " + String(error.c_str()));
-    Serial.println("Payload size was: " + String(payloadSize));
+  LOG_W("Not enough PSRAM for %d bars, falling back to %d", capacity,
+        MIN_HISTORY_BARS);
+  if (store.allocate(MIN_HISTORY_BARS)) {
+    return true;
+  }
+  LOG_E("Could not allocate the candle store");
+  return false;
+}
 
-    // Try with fallback data if JSON parsing fails
-    return fetchFallbackData(symbol);
+bool DataFetcher::allocateStaging(int capacity) {
+  if (fetch_capacity == capacity) {
+    return true;
   }
 
-  // Check if we have valid data
-  if (!doc["chart"]["result"][0]["timestamp"]) {
-    Serial.println("No timestamp data in response");
+  free(fetch_candles);
+  fetch_candles =
+      (enhanced_candle_t *)ps_malloc(capacity * sizeof(enhanced_candle_t));
+  fetch_capacity = (fetch_candles != NULL) ? capacity : 0;
+  if (fetch_candles == NULL) {
+    LOG_E("No PSRAM for %d staged bars", capacity);
     return false;
   }
+  return true;
+}
 
-  JsonArray timestamps = doc["chart"]["result"][0]["timestamp"].as<JsonArray>();
-  JsonObject quote = doc["chart"]["result"][0]["indicators"]["quote"][0];
-  JsonArray opens = quote["open"].as<JsonArray>();
-  JsonArray highs = quote["high"].as<JsonArray>();
-  JsonArray lows = quote["low"].as<JsonArray>();
-  JsonArray closes = quote["close"].as<JsonArray>();
+void DataFetcher::releaseStaging() {
+  free(fetch_candles);
+  fetch_candles = NULL;
+  fetch_capacity = 0;
+}
 
-  if (timestamps.size() == 0) {
-    Serial.println("No data points received");
+bool DataFetcher::fetchInitialData(const String &symbol, const String &interval,
+                                   const String &range, int capacity) {
+  if (!allocateStaging(capacity)) {
     return false;
   }
 
-  // Reset the buffer
-  reset();
+  // Rows arrive one column at a time, so a whole load is staged before any
+  // bar is complete. Once published it is dead weight: 28 bytes a bar,
+  // about 1.4 MB of PSRAM at MAX_HISTORY_BARS, beside the store itself.
+  bool loaded = streamInitialData(symbol, interval, range);
+  releaseStaging();
+  return loaded;
+}
 
-  // Load data into circular buffer
-  int dataSize = std::min((int)timestamps.size(), MAX_CANDLES);
-  int startIndex =
-      timestamps.size() - dataSize; // Start from the most recent data that fits
+bool DataFetcher::streamInitialData(const String &symbol,
+                                    const String &interval,
+                                    const String &range) {
+  LOG_I("Fetching initial data for %s with interval=%s range=%s",
+        symbol.c_str(), interval.c_str(), range.c_str());
 
-  for (int i = 0; i < dataSize; i++) {
-    int dataIndex = startIndex + i;
+  String url = String(FetchTask::baseUrl()) + "/v8/finance/chart/" + symbol +
+               "?interval=" + interval + "&range=" + range;
 
-    enhanced_candle_t candle;
-    candle.timestamp = timestamps[dataIndex].as<long>();
-    candle.open = opens[dataIndex].as<float>();
-    candle.high = highs[dataIndex].as<float>();
-    candle.low = lows[dataIndex].as<float>();
-    candle.close = closes[dataIndex].as<float>();
-    candle.is_complete = true; // Historical data is always complete
+  LOG_D("URL: %s", url.c_str());
+  int httpCode = HttpSession::get(url);
+  if (httpCode != HTTP_CODE_OK) {
+    LOG_W("HTTP request failed with code: %d", httpCode);
+    HttpSession::end();
+    return false;
+  }
 
-    updateCircularBuffer(candle);
+  // Candles are written into the staging ring while the body streams in,
+  // so nothing older than the store's capacity is ever held in memory
+  uint32_t heap_before = ESP.getFreeHeap();
+  unsigned long parse_start = millis();
+
+  // The session body stops at the end of the response, de-chunked
+  ChartStreamParser parser(storeStreamedValue, NULL);
+  bool parsed = parser.parse(HttpSession::body());
+  HttpSession::end();
+
+  unsigned long parse_ms = millis() - parse_start;
+  uint32_t rows = parser.getRowCount();
+
+  LOG_I("Streamed %u bytes, %u rows in %lu ms (heap low-water delta: %d "
+        "bytes)",
+        parser.getBytesConsumed(), rows, parse_ms,
+        (int)heap_before - (int)ESP.getMinFreeHeap());
+
+  if (!parsed && !parser.hasFailed() &&
+      parser.getCount(CHART_FIELD_TIMESTAMP) > 0) {
+    // Bars began but the body was cut short. Its last value may be
+    // corrupt and polls never ask for the rows it lost, so nothing is
+    // kept and the load is retried.
+    LOG_W("Chart body ended early after %u rows", rows);
+    return false;
   }
+  if (!parsed) {
+    LOG_W("Chart stream parsing failed");
 
-  current_price = candles[newest_candle_index].close;
-  initial_data_loaded = true;
+    // Try with fallback data if the stream could not be parsed
+    return fetchFallbackData(symbol);
+  }
+
+  // Slot i % capacity holds row i, matching the store's push order
+  int count = std::min((int)rows, fetch_capacity);
+  int newest = (rows - 1) % fetch_capacity;
+  int oldest = (newest - count + 1 + fetch_capacity) % fetch_capacity;
+
+  // The bar still forming is often null; report the last real close
+  float price = 0.0;
+  for (int i = 0; i < count && price <= 0; i++) {
+    price = fetch_candles[(newest - i + fetch_capacity) % fetch_capacity].close;
+  }
+
+  fetch_newest_timestamp = 0;
+  publishCandles(fetch_candles, fetch_capacity, oldest, count, true, price);
 
-  Serial.println("Loaded " + String(num_candles) +
-                 " candles. Current price: " + String(current_price));
+  LOG_I("Loaded %d candles. Current price: %.2f", count, price);
   return true;
 }
 
-String DataFetcher::getSmallerRange(const String &range) {
-  // Return a smaller range to reduce data size
-  if (range == "1y")
-    return "6mo";
-  if (range == "6mo")
-    return "3mo";
-  if (range == "3mo")
-    return "1mo";
-  if (range == "1mo")
-    return "5d";
-  if (range == "5d")
-    return "1d";
-  return range; // Can't reduce further
+void DataFetcher::publishCandles(const enhanced_candle_t *ring, int capacity,
+                                 int first, int count, bool replace,
+                                 float price) {
+  int sent = 0;
+  do {
+    int n = std::min(count - sent, CANDLE_BATCH_SIZE);
+    uint8_t flags = 0;
+    if (replace && sent == 0) {
+      flags |= CANDLE_BATCH_RESET;
+    }
+    if (sent + n < count) {
+      flags |= CANDLE_BATCH_PARTIAL;
+    }
+
+    candle_batch_t *batch = FetchTask::beginBatch(flags);
+    for (int i = 0; i < n; i++) {
+      batch->bars[i] = ring[(first + sent + i) % capacity];
+    }
+    batch->count = n;
+    batch->price = price;
+    FetchTask::commitBatch();
+
+    sent += n;
+  } while (sent < count);
+
+  if (count > 0) {
+    fetch_newest_timestamp =
+        std::max(fetch_newest_timestamp,
+                 ring[(first + count - 1) % capacity].timestamp);
+  }
+}
+
+bool DataFetcher::applyBatch(const candle_batch_t &batch) {
+  if (batch.flags & CANDLE_BATCH_RESET) {
+    reset();
+  }
+
+  // Bulk loads rebuild the view once at the end; polls fold bar by bar
+  bool bulk = (batch.flags & (CANDLE_BATCH_RESET | CANDLE_BATCH_PARTIAL)) ||
+              view_stale;
+  int base_seconds = getIntervalSeconds(current_interval);
+
+  for (int i = 0; i < batch.count; i++) {
+    if (mergeCandle(batch.bars[i]) && view_seconds > 0 && !bulk) {
+      CandleResampler::update(store, base_seconds, view, view_seconds,
+                              batch.bars[i].timestamp);
+    }
+  }
+
+  if (view_seconds > 0 && bulk) {
+    view_stale = (batch.flags & CANDLE_BATCH_PARTIAL) != 0;
+    if (!view_stale) {
+      CandleResampler::rebuild(store, base_seconds, view, view_seconds);
+    }
+  }
+
+  if (batch.price > 0) {
+    current_price = batch.price;
+  }
+  initial_data_loaded = store.size() > 0;
+
+  // Partial batches of a larger load are not worth a redraw
+  return !(batch.flags & CANDLE_BATCH_PARTIAL);
+}
+
+void DataFetcher::applyStreamedValue(enhanced_candle_t &candle,
+                                     ChartField field, double value) {
+  switch (field) {
+  case CHART_FIELD_TIMESTAMP:
+    // Timestamps precede the quote arrays, so this starts a fresh slot
+    memset(&candle, 0, sizeof(candle));
+    candle.timestamp = (time_t)value;
+    candle.is_complete = true; // Historical data is always complete
+    break;
+  case CHART_FIELD_OPEN:
+    candle.open = value;
+    break;
+  case CHART_FIELD_HIGH:
+    candle.high = value;
+    break;
+  case CHART_FIELD_LOW:
+    candle.low = value;
+    break;
+  case CHART_FIELD_CLOSE:
+    candle.close = value;
+    break;
+  case CHART_FIELD_VOLUME:
+    candle.volume = (uint32_t)value;
+    break;
+  default:
+    break;
+  }
+}
+
+void DataFetcher::storeStreamedValue(ChartField field, uint32_t index,
+                                     double value, void *ctx) {
+  applyStreamedValue(fetch_candles[index % fetch_capacity], field, value);
+}
+
+void DataFetcher::storePolledValue(ChartField field, uint32_t index,
+                                   double value, void *ctx) {
+  if (index < POLL_MAX_BARS) {
+    applyStreamedValue(poll_batch[index], field, value);
+  }
+}
+
+const JsonDocument &DataFetcher::chartFilter() {
+  // Built once. Keeps the same columns ChartStreamParser extracts, so meta,
+  // tradingPeriods and adjclose never reach the DOM.
+  static JsonDocument filter;
+  if (filter.isNull()) {
+    JsonObject result = filter["chart"]["result"].add<JsonObject>();
+    result["timestamp"] = true;
+    JsonObject quote = result["indicators"]["quote"].add<JsonObject>();
+    quote["open"] = true;
+    quote["high"] = true;
+    quote["low"] = true;
+    quote["close"] = true;
+    quote["volume"] = true;
+  }
+  return filter;
 }
 
 bool DataFetcher::fetchFallbackData(const String &symbol) {
-  Serial.println("Using fallback: fetching 1d data with daily interval");
+  LOG_I("Using fallback: fetching 1d data with daily interval");
 
-  HTTPClient http;
-  String url = "https://query1.finance.yahoo.com/v8/finance/chart/" + symbol +
+  String url = String(FetchTask::baseUrl()) + "/v8/finance/chart/" + symbol +
                "?interval=1d&range=1d";
 
-  http.begin(url);
-  int httpCode = http.GET();
+  int httpCode = HttpSession::get(url);
   if (httpCode != HTTP_CODE_OK) {
-    Serial.println("Fallback request failed");
-    http.end();
+    LOG_W("Fallback request failed");
+    HttpSession::end();
     return false;
   }
 
-  String payload = http.getString();
-  http.end();
+  uint32_t heap_before = ESP.getFreeHeap();
+  unsigned long parse_start = millis();
 
   JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, payload);
+  DeserializationError error =
+      deserializeJson(doc, HttpSession::body(),
+                      DeserializationOption::Filter(chartFilter()));
+  HttpSession::end();
+
+  LOG_D("Fallback JSON: %d bytes of DOM in %lu ms",
+        (int)heap_before - (int)ESP.getFreeHeap(), millis() - parse_start);
   if (error) {
-    Serial.println("Fallback JSON parsing failed");
+    LOG_W("Fallback JSON parsing failed");
     return false;
   }
 
@@ -186,7 +421,6 @@ bool DataFetcher::fetchFallbackData(const String &symbol) {
   }
 
   // Create a single candle from the most recent data
-  reset();
   enhanced_candle_t candle;
   int lastIndex = timestamps.size() - 1;
   candle.timestamp = timestamps[lastIndex].as<long>();
@@ -194,14 +428,13 @@ bool DataFetcher::fetchFallbackData(const String &symbol) {
   candle.high = quote["high"][lastIndex].as<float>();
   candle.low = quote["low"][lastIndex].as<float>();
   candle.close = closes[lastIndex].as<float>();
+  candle.volume = quote["volume"][lastIndex].as<uint32_t>();
   candle.is_complete = true;
 
-  updateCircularBuffer(candle);
-  current_price = candle.close;
-  initial_data_loaded = true;
+  fetch_newest_timestamp = 0;
+  publishCandles(&candle, 1, 0, 1, true, candle.close);
 
-  Serial.println("Fallback data loaded: 1 candle, price: " +
-                 String(current_price));
+  LOG_I("Fallback data loaded: 1 candle, price: %.2f", candle.close);
   return true;
 }
 
@@ -210,6 +443,11 @@ bool DataFetcher::updateData() {
   static unsigned long last_update_millis =
       0; // For test data (millisecond precision)
 
+  // Always drain finished fetches so the network task never waits on a full
+  // queue, even in test mode where they are stale and get dropped
+  bool changed = applyPendingBatches();
+  Watchlist::applyPending();
+
   if (USE_TEST_DATA) {
     // TEST DATA MODE: Use millis() for precise millisecond timing
     if (millis() - last_update_millis < INTRADAY_UPDATE_INTERVAL) {
@@ -224,146 +462,164 @@ bool DataFetcher::updateData() {
     float price = getRandomPrice();
 
     // Track candle state before update
-    int candles_before = num_candles;
-    bool was_complete =
-        (num_candles > 0) ? candles[newest_candle_index].is_complete : false;
+    int candles_before = store.size();
+    bool was_complete = (store.size() > 0) ? store.isComplete(0) : false;
 
     buildIntradayCandle(price, now);
 
     // Track candle state after update
-    int candles_after = num_candles;
-    bool is_complete =
-        (num_candles > 0) ? candles[newest_candle_index].is_complete : false;
+    int candles_after = store.size();
+    bool is_complete = (store.size() > 0) ? store.isComplete(0) : false;
 
     // Enhanced debug output every few seconds
     static unsigned long lastTestDebug = 0;
     if (millis() - lastTestDebug > 3000) { // Every 3 seconds instead of 5
-      Serial.println("\n=== TEST DATA STATUS ===");
-      Serial.println("Update interval: " + String(INTRADAY_UPDATE_INTERVAL) +
-                     "ms");
-      Serial.println("Updates per bar: " + String(TEST_DATA_UPDATES_PER_BAR));
-      Serial.println("Current price: " + String(price));
-      Serial.println("Total candles: " + String(num_candles));
-
-      if (num_candles > 0) {
-        Serial.println("Current candle status: " +
-                       String(is_complete ? "COMPLETE" : "BUILDING"));
-        Serial.println("Current candle OHLC: O:" +
-                       String(candles[newest_candle_index].open) +
-                       " H:" + String(candles[newest_candle_index].high) +
-                       " L:" + String(candles[newest_candle_index].low) +
-                       " C:" + String(candles[newest_candle_index].close));
+      LOG_D("Test data: every %d ms, %d updates per bar, price %.2f, %d "
+            "candles",
+            INTRADAY_UPDATE_INTERVAL, TEST_DATA_UPDATES_PER_BAR, price,
+            store.size());
+
+      if (store.size() > 0) {
+        enhanced_candle_t newest = store.get(0);
+        LOG_D("Test data: candle %s O:%.2f H:%.2f L:%.2f C:%.2f",
+              is_complete ? "COMPLETE" : "BUILDING", newest.open, newest.high,
+              newest.low, newest.close);
       }
 
       // Show when candles complete or new ones start
       if (candles_after > candles_before) {
-        Serial.println(">>> NEW CANDLE CREATED <<<");
+        LOG_D("Test data: new candle created");
       }
       if (!was_complete && is_complete) {
-        Serial.println(">>> CANDLE COMPLETED <<<");
+        LOG_D("Test data: candle completed");
       }
 
-      Serial.println("========================\n");
       lastTestDebug = millis();
     }
 
     return true;
   }
 
-  // REAL DATA MODE: Use time() but convert interval to seconds
-  time_t now;
-  time(&now);
-
-  // Convert milliseconds to seconds for real data timing comparison
-  int update_interval_seconds = INTRADAY_UPDATE_INTERVAL / 1000;
-  if (update_interval_seconds < 1) {
-    update_interval_seconds = 1; // Minimum 1 second for real data
+  // REAL DATA MODE: The fetch task does the network work; we only apply
+  // finished batches, so rendering keeps its cadence during slow requests
+  if (changed && store_live) {
+    CandleSnapshot::checkpoint(current_symbol, current_interval, store, false);
   }
+  return changed;
+}
 
-  // Check if we need to update
-  if (now - last_update_time < update_interval_seconds) {
-    return false;
+bool DataFetcher::applyPendingBatches() {
+  bool changed = false;
+  candle_batch_t *batch;
+  while ((batch = FetchTask::frontBatch()) != NULL) {
+    if (batch->generation == load_generation) {
+      changed |= applyBatch(*batch);
+    }
+    FetchTask::popBatch();
   }
+  return changed;
+}
 
-  last_update_time = now;
-
-  // Check market hours if enforced (for real data only)
-  if (ENFORCE_MARKET_HOURS &&
-      !StockTracker::MarketHoursChecker::isMarketOpen()) {
-    Serial.println("Market is closed, skipping real data update");
+bool DataFetcher::resumeFrom(const String &interval, time_t newest,
+                             time_t now) {
+  int interval_seconds = getIntervalSeconds(interval);
+  if (interval_seconds <= 0 || newest <= 0 || now < newest ||
+      (now - newest) / interval_seconds > RESUME_MAX_BARS) {
     return false;
   }
 
-  // Fetch current price for intraday candle building (real data)
-  HTTPClient http;
-  String url = "https://query1.finance.yahoo.com/v8/finance/chart/" +
-               current_symbol + "?interval=1m&range=1d";
+  fetch_newest_timestamp = newest;
+  LOG_I("Resuming %s from snapshot, %ld s behind", interval.c_str(),
+        (long)(now - newest));
+  return true;
+}
 
-  Serial.println("Fetching real data from: " + url);
-  http.begin(url);
-  http.setTimeout(10000); // 10 second timeout
-  int httpCode = http.GET();
+bool DataFetcher::pollNewBars(const String &symbol, const String &interval,
+                              time_t now) {
+  // Only ask for bars at or after the newest one we hold. The newest bar is
+  // re-requested so its still-forming OHLC gets refreshed.
+  int interval_seconds = getIntervalSeconds(interval);
+  time_t period1 = (fetch_newest_timestamp > 0) ? fetch_newest_timestamp
+                                                : now - interval_seconds;
+  time_t period2 = now + interval_seconds;
+
+  // Formatted in place: this runs every poll, and each String `+` would be
+  // another heap allocation
+  char url[192];
+  snprintf(url, sizeof(url),
+           "%s/v8/finance/chart/%s?interval=%s&period1=%ld&period2=%ld",
+           FetchTask::baseUrl(), symbol.c_str(), interval.c_str(),
+           (long)period1, (long)period2);
+
+  LOG_D("Polling new bars from: %s", url);
+  int httpCode = HttpSession::get(url);
 
   if (httpCode != HTTP_CODE_OK) {
-    Serial.println("HTTP request failed with code: " + String(httpCode));
-    http.end();
+    LOG_W("HTTP request failed with code: %d", httpCode);
+    HttpSession::end();
     return false;
   }
 
-  String payload = http.getString();
-  http.end();
+  unsigned long parse_start = millis();
+  ChartStreamParser parser(storePolledValue, NULL);
+  bool parsed = parser.parse(HttpSession::body());
+  HttpSession::end();
 
-  if (payload.length() == 0) {
-    Serial.println("Empty response received");
+  if (!parsed) {
+    LOG_D("No bars in poll response");
     return false;
   }
 
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, payload);
-  if (error) {
-    Serial.println("JSON parsing failed: " + String(error.c_str()));
-    return false;
-  }
+  // Anything past POLL_MAX_BARS is picked up by the next poll
+  int rows = std::min((int)parser.getRowCount(), POLL_MAX_BARS);
+  int valid = 0;
+  int appended = 0;
 
-  // Check if we have valid response structure
-  if (!doc["chart"]["result"][0]["timestamp"]) {
-    Serial.println("Invalid response structure - no timestamp data");
-    return false;
+  for (int i = 0; i < rows; i++) {
+    enhanced_candle_t &bar = poll_batch[i];
+
+    // Yahoo reports the forming bar and gaps as nulls
+    if (bar.close <= 0 || bar.open <= 0 || bar.high <= 0 || bar.low <= 0) {
+      continue;
+    }
+    bar.is_complete = (bar.timestamp + interval_seconds <= now);
+    if (bar.timestamp > fetch_newest_timestamp) {
+      appended++;
+    }
+    poll_batch[valid++] = bar;
   }
 
-  JsonArray timestamps = doc["chart"]["result"][0]["timestamp"].as<JsonArray>();
-  JsonObject quote = doc["chart"]["result"][0]["indicators"]["quote"][0];
-  JsonArray closes = quote["close"].as<JsonArray>();
+  LOG_D("Poll got %d bars (%d new) from %u bytes in %lu ms", valid, appended,
+        parser.getBytesConsumed(), millis() - parse_start);
 
-  if (timestamps.size() == 0 || closes.size() == 0) {
-    Serial.println("No price data in response");
+  if (valid == 0) {
     return false;
   }
 
-  // Get the most recent price
-  float latestPrice = 0.0;
-  time_t latestTimestamp = 0;
+  // The UI merges these into its ring by timestamp
+  publishCandles(poll_batch, POLL_MAX_BARS, 0, valid, false,
+                 poll_batch[valid - 1].close);
+  return true;
+}
 
-  // Search backwards through the arrays to find the most recent non-null price
-  for (int i = closes.size() - 1; i >= 0; i--) {
-    if (!closes[i].isNull() && closes[i].as<float>() > 0) {
-      latestPrice = closes[i].as<float>();
-      latestTimestamp = timestamps[i].as<long>();
-      break;
-    }
+bool DataFetcher::mergeCandle(const enhanced_candle_t &candle) {
+  if (store.size() == 0 || candle.timestamp > store.timestamp(0)) {
+    updateCircularBuffer(candle);
+    return true;
   }
 
-  if (latestPrice > 0) {
-    Serial.println("Real data update - Latest price: " + String(latestPrice) +
-                   " at timestamp: " + String(latestTimestamp));
-
-    current_price = latestPrice;
-    buildIntradayCandle(latestPrice, latestTimestamp);
-    return true;
-  } else {
-    Serial.println("No valid price found in response");
-    return false;
+  // Replace the stored bar with the same timestamp, newest first
+  for (int age = 0; age < store.size(); age++) {
+    time_t stored = store.timestamp(age);
+    if (stored == candle.timestamp) {
+      store.replace(age, candle);
+      return true;
+    }
+    if (stored < candle.timestamp) {
+      break; // Would need an insert in the middle; not worth the shuffle
+    }
   }
+  return false;
 }
 
 void DataFetcher::buildIntradayCandle(float price, time_t timestamp) {
@@ -371,17 +627,17 @@ void DataFetcher::buildIntradayCandle(float price, time_t timestamp) {
   static int last_candle_count = 0; // Track if data was reset
 
   // Reset update counter if data was cleared
-  if (num_candles < last_candle_count || num_candles == 0) {
+  if (store.size() < last_candle_count || store.size() == 0) {
     update_count = 0;
-    Serial.println("Test data: Update counter reset due to data clear");
+    LOG_D("Test data: Update counter reset due to data clear");
   }
-  last_candle_count = num_candles;
+  last_candle_count = store.size();
 
   if (USE_TEST_DATA) {
     // TEST DATA MODE: Use update counting
     update_count++;
 
-    if (num_candles == 0) {
+    if (store.size() == 0) {
       // Create the very first candle
       enhanced_candle_t newCandle;
       newCandle.timestamp = timestamp;
@@ -389,14 +645,15 @@ void DataFetcher::buildIntradayCandle(float price, time_t timestamp) {
       newCandle.high = price;
       newCandle.low = price;
       newCandle.close = price;
+      newCandle.volume = 0;
       newCandle.is_complete = false; // Incomplete until we reach update limit
 
       updateCircularBuffer(newCandle);
-      Serial.println("Test data: Created first candle - Update 1/" +
-                     String(TEST_DATA_UPDATES_PER_BAR));
+      LOG_V("Test data: Created first candle - Update 1/%d",
+            TEST_DATA_UPDATES_PER_BAR);
     } else {
       // Check if current candle is complete and we need a new one
-      if (candles[newest_candle_index].is_complete) {
+      if (store.isComplete(0)) {
         // Previous candle was completed, start a new one
         enhanced_candle_t newCandle;
         newCandle.timestamp = timestamp;
@@ -404,40 +661,35 @@ void DataFetcher::buildIntradayCandle(float price, time_t timestamp) {
         newCandle.high = price;
         newCandle.low = price;
         newCandle.close = price;
+        newCandle.volume = 0;
         newCandle.is_complete = false; // Start as incomplete
 
         updateCircularBuffer(newCandle);
         update_count = 1; // Reset counter for new candle
-        Serial.println("Test data: Started new candle - Update 1/" +
-                       String(TEST_DATA_UPDATES_PER_BAR) +
-                       " (Price: " + String(price) + ")");
+        LOG_V("Test data: Started new candle - Update 1/%d (Price: %.2f)",
+              TEST_DATA_UPDATES_PER_BAR, price);
       } else {
         // Update the current incomplete candle
-        candles[newest_candle_index].close = price;
-        candles[newest_candle_index].high =
-            std::max(candles[newest_candle_index].high, price);
-        candles[newest_candle_index].low =
-            std::min(candles[newest_candle_index].low, price);
-        candles[newest_candle_index].timestamp = timestamp;
+        enhanced_candle_t current = store.get(0);
+        current.close = price;
+        current.high = std::max(current.high, price);
+        current.low = std::min(current.low, price);
+        current.timestamp = timestamp;
 
         // Check if we should complete this candle
         if (update_count >= TEST_DATA_UPDATES_PER_BAR) {
-          candles[newest_candle_index].is_complete = true;
-          Serial.println(
-              "Test data: Completed candle after " + String(update_count) +
-              " updates" + " (Final price: " + String(price) +
-              ", Open: " + String(candles[newest_candle_index].open) +
-              ", High: " + String(candles[newest_candle_index].high) +
-              ", Low: " + String(candles[newest_candle_index].low) + ")");
+          current.is_complete = true;
+          LOG_V("Test data: Completed candle after %d updates (Final price: "
+                "%.2f, Open: %.2f, High: %.2f, Low: %.2f)",
+                update_count, price, current.open, current.high, current.low);
           // Note: Don't reset update_count here - let it reset when new candle
           // starts
         } else {
-          Serial.println(
-              "Test data: Update " + String(update_count) + "/" +
-              String(TEST_DATA_UPDATES_PER_BAR) + " - Price: " + String(price) +
-              " (Range: " + String(candles[newest_candle_index].low) + "-" +
-              String(candles[newest_candle_index].high) + ")");
+          LOG_V("Test data: Update %d/%d - Price: %.2f (Range: %.2f-%.2f)",
+                update_count, TEST_DATA_UPDATES_PER_BAR, price, current.low,
+                current.high);
         }
+        store.replace(0, current);
       }
     }
 
@@ -448,25 +700,25 @@ void DataFetcher::buildIntradayCandle(float price, time_t timestamp) {
   // REAL DATA MODE: Use existing time-based logic (unchanged)
   int interval_seconds = getIntervalSeconds(YAHOO_INTERVAL);
 
-  if (num_candles == 0 ||
-      shouldCreateNewCandle(timestamp, candles[newest_candle_index].timestamp,
-                            interval_seconds)) {
+  if (store.size() == 0 ||
+      shouldCreateNewCandle(timestamp, store.timestamp(0), interval_seconds)) {
     enhanced_candle_t newCandle;
     newCandle.timestamp = timestamp;
     newCandle.open = price;
     newCandle.high = price;
     newCandle.low = price;
     newCandle.close = price;
+    newCandle.volume = 0;
     newCandle.is_complete = true;
 
     updateCircularBuffer(newCandle);
   } else {
-    candles[newest_candle_index].close = price;
-    candles[newest_candle_index].high =
-        std::max(candles[newest_candle_index].high, price);
-    candles[newest_candle_index].low =
-        std::min(candles[newest_candle_index].low, price);
-    candles[newest_candle_index].is_complete = true;
+    enhanced_candle_t current = store.get(0);
+    current.close = price;
+    current.high = std::max(current.high, price);
+    current.low = std::min(current.low, price);
+    current.is_complete = true;
+    store.replace(0, current);
   }
 
   current_price = price;
@@ -480,111 +732,32 @@ bool DataFetcher::shouldCreateNewCandle(time_t current_time,
 }
 
 int DataFetcher::getIntervalSeconds(const String &interval) {
-  if (interval == "1m")
-    return 60;
-  if (interval == "2m")
-    return 120;
-  if (interval == "5m")
-    return 300;
-  if (interval == "15m")
-    return 900;
-  if (interval == "30m")
-    return 1800;
-  if (interval == "60m" || interval == "1h")
-    return 3600;
-  if (interval == "90m")
-    return 5400;
-  if (interval == "1d")
-    return 86400;
+  int seconds = CandleResampler::bucketSeconds(interval);
+  if (seconds > 0) {
+    return seconds;
+  }
 
   // Default to the configured candle collection duration
   return CANDLE_COLLECTION_DURATION;
 }
 
 void DataFetcher::updateCircularBuffer(const enhanced_candle_t &candle) {
-  if (num_candles < MAX_CANDLES) {
-    num_candles++;
-  }
+  store.push(candle);
+}
 
-  newest_candle_index = (newest_candle_index + 1) % MAX_CANDLES;
-  candles[newest_candle_index] = candle;
+bool DataFetcher::getVisibleExtrema(int bars, float *low, float *high) {
+  return shown().extremaOf(bars, low, high);
 }
 
 void DataFetcher::getPriceLevels(float *min_price, float *max_price) {
-  *min_price = std::numeric_limits<float>::max();
-  *max_price = std::numeric_limits<float>::lowest();
-
-  if (num_candles == 0) {
-    *min_price = 0;
-    *max_price = 100;
-    return;
-  }
-
-  for (int i = 0; i < num_candles; i++) {
-    int index =
-        (newest_candle_index - num_candles + i + 1 + MAX_CANDLES) % MAX_CANDLES;
-    *min_price = std::min(*min_price, candles[index].low);
-    *max_price = std::max(*max_price, candles[index].high);
-  }
-
-  // Round to 2 decimal places
-  *min_price = floor(*min_price * 100) / 100;
-  *max_price = ceil(*max_price * 100) / 100;
+  getPriceLevelsForVisibleBars(min_price, max_price, shown().size());
 }
 
 void DataFetcher::getPriceLevelsForVisibleBars(float *min_price,
                                                float *max_price,
                                                int bars_to_show) {
-  *min_price = std::numeric_limits<float>::max();
-  *max_price = std::numeric_limits<float>::lowest();
-
-  if (num_candles == 0) {
-    *min_price = 0;
-    *max_price = 100;
-    return;
-  }
-
-  // Limit bars_to_show to available data
-  int barsToCheck = std::min(bars_to_show, num_candles);
-
-  Serial.printf("Price calculation debug:\n");
-  Serial.printf("  Requested bars: %d\n", bars_to_show);
-  Serial.printf("  Available candles: %d\n", num_candles);
-  Serial.printf("  Bars to check: %d\n", barsToCheck);
-  Serial.printf("  Newest index: %d\n", newest_candle_index);
-
   // Calculate min/max for only the MOST RECENT visible bars
-  // We want the newest barsToCheck candles, not the oldest ones
-  for (int i = 0; i < barsToCheck; i++) {
-    // Calculate index for the i-th most recent candle
-    // newest_candle_index is the most recent (i=0)
-    // newest_candle_index-1 is the second most recent (i=1), etc.
-    int index = (newest_candle_index - i + MAX_CANDLES) % MAX_CANDLES;
-
-    const enhanced_candle_t &candle = candles[index];
-
-    // Debug output for first few candles
-    if (i < 5) {
-      Serial.printf(
-          "  Bar %d: index=%d, high=%.2f, low=%.2f, open=%.2f, close=%.2f\n", i,
-          index, candle.high, candle.low, candle.open, candle.close);
-    }
-
-    // Validate that we have real data (not uninitialized)
-    if (candle.high > 0 && candle.low > 0 && candle.open > 0 &&
-        candle.close > 0) {
-      *min_price = std::min(*min_price, candle.low);
-      *max_price = std::max(*max_price, candle.high);
-    } else {
-      Serial.printf(
-          "  Warning: Invalid candle data at index %d (high=%.2f, low=%.2f)\n",
-          index, candle.high, candle.low);
-    }
-  }
-
-  // If we didn't find any valid data, use fallback
-  if (*min_price == std::numeric_limits<float>::max()) {
-    Serial.println("  No valid price data found, using fallback");
+  if (!getVisibleExtrema(bars_to_show, min_price, max_price)) {
     *min_price = 0;
     *max_price = 100;
     return;
@@ -593,8 +766,6 @@ void DataFetcher::getPriceLevelsForVisibleBars(float *min_price,
   // Round to 2 decimal places
   *min_price = floor(*min_price * 100) / 100;
   *max_price = ceil(*max_price * 100) / 100;
-
-  Serial.printf("  Final range: %.2f - %.2f\n", *min_price, *max_price);
 }
 
 float DataFetcher::getRandomPrice() {
@@ -603,20 +774,19 @@ float DataFetcher::getRandomPrice() {
   static int lastCandleCount = 0; // Track if data was reset
 
   // Reset price initialization if data was cleared
-  if (num_candles < lastCandleCount) {
+  if (store.size() < lastCandleCount) {
     priceInitialized = false;
     lastPrice = 250.0;
-    Serial.println("Test data: Price generator reset due to data clear");
+    LOG_D("Test data: Price generator reset due to data clear");
   }
-  lastCandleCount = num_candles;
+  lastCandleCount = store.size();
 
   // If we have candles in the buffer, use the most recent close price
-  if (!priceInitialized && num_candles > 0) {
-    lastPrice = candles[newest_candle_index].close;
+  if (!priceInitialized && store.size() > 0) {
+    lastPrice = store.close(0);
     priceInitialized = true;
-    Serial.println(
-        "Test data: Initialized price continuation from last candle: " +
-        String(lastPrice));
+    LOG_D("Test data: Initialized price continuation from last candle: %.2f",
+          lastPrice);
   }
 
   // Generate realistic price movement (-1% to +1% change)
@@ -631,9 +801,8 @@ float DataFetcher::getRandomPrice() {
 }
 
 void DataFetcher::initializeTestData() {
-  Serial.println("Initializing realistic test data...");
-  Serial.println("Using " + String(TEST_DATA_UPDATES_PER_BAR) +
-                 " updates per candle for realistic OHLC generation");
+  LOG_I("Initializing test data, %d updates per candle",
+        TEST_DATA_UPDATES_PER_BAR);
 
   float base_price = 250.0;
   time_t now;
@@ -641,11 +810,11 @@ void DataFetcher::initializeTestData() {
 
   // IMPORTANT: Reset the buffer first to clear any existing real data
   reset();
-  Serial.println("Cleared existing data for test mode");
+  LOG_D("Cleared existing data for test mode");
 
   // Pre-populate with historical test data
   int test_candles =
-      std::min(MAX_CANDLES - 5, 500); // Generate up to 500 test candles
+      std::min(store.capacity() - 5, 500); // Generate up to 500 test candles
 
   for (int i = 0; i < test_candles; i++) {
     enhanced_candle_t candle;
@@ -656,13 +825,11 @@ void DataFetcher::initializeTestData() {
     candle.high = starting_price;
     candle.low = starting_price;
     candle.close = starting_price;
+    candle.volume = 0;
 
     // Simulate TEST_DATA_UPDATES_PER_BAR price updates to build this candle
     float current_price = starting_price;
 
-    // Serial.printf("Generating candle %d starting at %.2f with %d updates:\n",
-    //              i, starting_price, TEST_DATA_UPDATES_PER_BAR);
-
     for (int update = 0; update < TEST_DATA_UPDATES_PER_BAR; update++) {
       // Generate realistic price movement for each update
       // Use smaller movements for individual updates (0.1% to 0.5% per update)
@@ -677,15 +844,6 @@ void DataFetcher::initializeTestData() {
       candle.high = std::max(candle.high, current_price);
       candle.low = std::min(candle.low, current_price);
       candle.close = current_price; // Close is always the last price
-
-      // Debug output for first few updates of first few candles
-      // if (i < 3 && update < 5) {
-      //     Serial.printf("  Update %d: %.2f (change: %+.3f)\n",
-      //                  update + 1, current_price, price_change);
-      // } else if (i < 3 && update == TEST_DATA_UPDATES_PER_BAR - 1) {
-      //     Serial.printf("  Update %d (final): %.2f\n", update + 1,
-      //     current_price);
-      // }
     }
 
     // Ensure low is never higher than open/close and high is never lower
@@ -703,32 +861,27 @@ void DataFetcher::initializeTestData() {
 
     // Summary for first few candles
     if (i < 5) {
-      float price_move = candle.close - candle.open;
-      float price_range = candle.high - candle.low;
-      Serial.printf("Candle %d complete: O:%.2f H:%.2f L:%.2f C:%.2f (Move: "
-                    "%+.2f, Range: %.2f)\n",
-                    i, candle.open, candle.high, candle.low, candle.close,
-                    price_move, price_range);
+      LOG_V("Candle %d complete: O:%.2f H:%.2f L:%.2f C:%.2f (Move: %+.2f, "
+            "Range: %.2f)",
+            i, candle.open, candle.high, candle.low, candle.close,
+            candle.close - candle.open, candle.high - candle.low);
     }
   }
 
-  current_price = candles[newest_candle_index].close;
+  current_price = store.close(0);
   initial_data_loaded = true;
 
-  Serial.println("\n=== Test Data Generation Complete ===");
-  Serial.println("Generated " + String(num_candles) + " realistic candles");
-  Serial.println("Each candle built from " + String(TEST_DATA_UPDATES_PER_BAR) +
-                 " price updates");
-  Serial.println("Final price for live continuation: " + String(current_price));
+  LOG_I("Generated %d test candles, final price %.2f", store.size(),
+        current_price);
 
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
   // Calculate and display statistics
   float total_range = 0;
   float total_movement = 0;
   int up_candles = 0, down_candles = 0;
 
-  for (int i = 0; i < std::min(num_candles, 50); i++) { // Check last 50 candles
-    int idx = (newest_candle_index - i + MAX_CANDLES) % MAX_CANDLES;
-    const enhanced_candle_t &c = candles[idx];
+  for (int i = 0; i < std::min(store.size(), 50); i++) { // Check last 50 candles
+    enhanced_candle_t c = store.get(i);
 
     total_range += (c.high - c.low);
     float movement = c.close - c.open;
@@ -740,30 +893,12 @@ void DataFetcher::initializeTestData() {
       down_candles++;
   }
 
-  int sample_size = std::min(num_candles, 50);
-  Serial.println("Statistics for last " + String(sample_size) + " candles:");
-  Serial.printf("  Average range: %.2f\n", total_range / sample_size);
-  Serial.printf("  Average movement: %.2f\n", total_movement / sample_size);
-  Serial.printf("  Up candles: %d, Down candles: %d, Doji: %d\n", up_candles,
-                down_candles, sample_size - up_candles - down_candles);
-
-  // Print some sample candles for verification - FIXED: Use ASCII characters
-  Serial.println("\nSample candles (most recent):");
-  for (int i = 0; i < std::min(5, num_candles); i++) {
-    int idx = (newest_candle_index - i + MAX_CANDLES) % MAX_CANDLES;
-    const enhanced_candle_t &c = candles[idx];
-    float move = c.close - c.open;
-    float range = c.high - c.low;
-
-    // FIXED: Use simple ASCII characters instead of Unicode
-    char direction = (move > 0) ? '^' : (move < 0) ? 'v' : '-';
-
-    // Serial.printf("  Candle -%d: O:%.2f H:%.2f L:%.2f C:%.2f %c (Move:%+.2f
-    // Range:%.2f)\n",
-    //              i, c.open, c.high, c.low, c.close, direction, move, range);
-  }
-
-  Serial.println("Ready for live test data updates...\n");
+  int sample_size = std::min(store.size(), 50);
+  LOG_D("Last %d candles: average range %.2f, average move %.2f, %d up, %d "
+        "down, %d doji",
+        sample_size, total_range / sample_size, total_movement / sample_size,
+        up_candles, down_candles, sample_size - up_candles - down_candles);
+#endif
 }
 
 // Also add the validation function without Unicode characters:
@@ -771,25 +906,22 @@ bool DataFetcher::validateCandle(const enhanced_candle_t &candle) {
   // Ensure OHLC relationships are valid
   if (candle.high < candle.open || candle.high < candle.close ||
       candle.high < candle.low) {
-    Serial.printf("ERROR: Invalid high %.2f vs O:%.2f H:%.2f L:%.2f C:%.2f\n",
-                  candle.high, candle.open, candle.high, candle.low,
-                  candle.close);
+    LOG_E("Invalid high %.2f vs O:%.2f H:%.2f L:%.2f C:%.2f", candle.high,
+          candle.open, candle.high, candle.low, candle.close);
     return false;
   }
 
   if (candle.low > candle.open || candle.low > candle.close ||
       candle.low > candle.high) {
-    Serial.printf("ERROR: Invalid low %.2f vs O:%.2f H:%.2f L:%.2f C:%.2f\n",
-                  candle.low, candle.open, candle.high, candle.low,
-                  candle.close);
+    LOG_E("Invalid low %.2f vs O:%.2f H:%.2f L:%.2f C:%.2f", candle.low,
+          candle.open, candle.high, candle.low, candle.close);
     return false;
   }
 
   if (candle.open <= 0 || candle.close <= 0 || candle.high <= 0 ||
       candle.low <= 0) {
-    Serial.printf(
-        "ERROR: Negative/zero prices in candle O:%.2f H:%.2f L:%.2f C:%.2f\n",
-        candle.open, candle.high, candle.low, candle.close);
+    LOG_E("Negative/zero prices in candle O:%.2f H:%.2f L:%.2f C:%.2f",
+          candle.open, candle.high, candle.low, candle.close);
     return false;
   }
 
@@ -797,8 +929,9 @@ bool DataFetcher::validateCandle(const enhanced_candle_t &candle) {
 }
 
 void DataFetcher::reset() {
-  newest_candle_index = -1;
-  num_candles = 0;
+  store.clear();
+  view.clear();
+  view_stale = false;
   last_update_time = 0;
   current_price = 0.0;
   initial_data_loaded = false;
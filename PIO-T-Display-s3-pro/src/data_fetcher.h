@@ -1,32 +1,51 @@
 #ifndef DATA_FETCHER_H
 #define DATA_FETCHER_H
 
+#include "candle_resampler.h"
+#include "candle_store.h"
+#include "chart_stream_parser.h"
 #include "config.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <time.h>
 
+#define POLL_MAX_BARS 64 // Bars merged per incremental poll
+#define RESUME_MAX_BARS (4 * POLL_MAX_BARS) // Larger snapshot gaps reload
+
+#define CANDLE_BATCH_SIZE POLL_MAX_BARS
+#define CANDLE_BATCH_RESET 0x01   // Clear the store before applying
+#define CANDLE_BATCH_PARTIAL 0x02 // More batches of the same load follow
+
+// Bars handed from the network task to the UI core in one queue slot
 typedef struct {
-  float open;
-  float close;
-  float high;
-  float low;
-  time_t timestamp;
-  bool is_complete; // Flag to indicate if candle is complete
-} enhanced_candle_t;
+  uint32_t generation; // Load request this batch answers
+  uint8_t flags;
+  uint8_t count;
+  float price; // Latest price, 0 if unknown
+  enhanced_candle_t bars[CANDLE_BATCH_SIZE];
+} candle_batch_t;
 
 class DataFetcher {
 private:
-  static enhanced_candle_t candles[MAX_CANDLES];
-  static int newest_candle_index;
-  static int num_candles;
+  static CandleStore store; // Bars at the fetched interval
+  static CandleStore view;  // store folded into the display interval
+  static int view_seconds;  // 0 while store is shown as-is
+  static bool view_stale;   // A bulk load is still arriving
   static time_t last_update_time;
   static float current_price;
   static bool initial_data_loaded;
   static String current_symbol;
-  static String current_interval;
+  static String current_interval; // Interval actually fetched
   static String current_range;
+  static uint32_t load_generation;
+  static bool store_live; // Holds fetched bars, not test data
+
+  // Network task side; never touched from the UI core
+  static enhanced_candle_t *fetch_candles; // Load staging, freed after it
+  static int fetch_capacity;
+  static enhanced_candle_t poll_batch[POLL_MAX_BARS];  // Staging for polls
+  static time_t fetch_newest_timestamp;
 
   // Helper methods
   static bool fetchYahooData(const String &symbol, const String &interval,
@@ -39,21 +58,56 @@ private:
                                     int interval_seconds);
   static void buildIntradayCandle(float price, time_t timestamp);
   static bool isDataStale();
-  static String getSmallerRange(const String &range);
+  static void applyStreamedValue(enhanced_candle_t &candle, ChartField field,
+                                 double value);
+  static void storeStreamedValue(ChartField field, uint32_t index,
+                                 double value, void *ctx);
+  static void storePolledValue(ChartField field, uint32_t index, double value,
+                               void *ctx);
+  static bool mergeCandle(const enhanced_candle_t &candle);
+  static bool applyBatch(const candle_batch_t &batch);
+  static bool applyPendingBatches();
+  static void publishCandles(const enhanced_candle_t *ring, int capacity,
+                             int first, int count, bool replace, float price);
   static bool fetchFallbackData(const String &symbol);
+  static const JsonDocument &chartFilter();
+  static bool allocateStore(int capacity);
+  static bool allocateStaging(int capacity);
+  static void releaseStaging();
+  static bool streamInitialData(const String &symbol, const String &interval,
+                                const String &range);
+  static String fetchIntervalFor(const String &interval, const String &range);
+  static bool selectView(const String &interval);
+  static time_t restoreSnapshot();
+  static const CandleStore &shown() {
+    return (view_seconds > 0) ? view : store;
+  }
 
 public:
   static bool initialize(const String &symbol);
   static bool updateData();
+  // Shows another interval folded from the bars already held; false when
+  // it cannot be derived and has to be fetched
+  static bool switchInterval(const String &interval);
+  // Called from FetchTask only
   static bool fetchInitialData(const String &symbol, const String &interval,
-                               const String &range);
-  static enhanced_candle_t *getCandles() { return candles; }
-  static int getCandleCount() { return num_candles; }
-  static int getNewestIndex() { return newest_candle_index; }
+                               const String &range, int capacity);
+  static bool pollNewBars(const String &symbol, const String &interval,
+                          time_t now);
+  // Lets polls fill the gap after a restored snapshot instead of reloading
+  // the whole range; false when the gap is too long
+  static bool resumeFrom(const String &interval, time_t newest, time_t now);
+  // Checkpoints the current history now, e.g. before a symbol change
+  static void saveSnapshot();
+  // Bars by age, 0 being the newest
+  static enhanced_candle_t getCandle(int age) { return shown().get(age); }
+  static int getCandleCount() { return shown().size(); }
+  static const CandleStore &getStore() { return shown(); }
   static float getCurrentPrice() { return current_price; }
   static void getPriceLevels(float *min_price, float *max_price);
   static void getPriceLevelsForVisibleBars(float *min_price, float *max_price,
                                            int bars_to_show); // NEW METHOD
+  static bool getVisibleExtrema(int bars, float *low, float *high);
   static void initializeTestData();
   static bool validateCandle(const enhanced_candle_t &candle);
   static void reset();
@@ -1,9 +1,33 @@
 #include "enhanced_candle_stick.h"
+#include "candle_rasterizer.h"
 #include "config.h"
+#include "log.h"
 #include "market_hours.h"
+#include "metrics.h"
 #include "ui.h"
 #include <algorithm>
 
+// Retained renderer state
+lv_obj_t *EnhancedCandleStick::container = NULL;
+lv_obj_t **EnhancedCandleStick::wick_pool = NULL;
+lv_obj_t **EnhancedCandleStick::body_pool = NULL;
+candle_geom_t *EnhancedCandleStick::geom_cache = NULL;
+int EnhancedCandleStick::pool_size = 0;
+lv_obj_t *EnhancedCandleStick::grid_pool[MAX_GRIDLINES];
+lv_coord_t EnhancedCandleStick::grid_y[MAX_GRIDLINES];
+lv_obj_t *EnhancedCandleStick::price_line = NULL;
+lv_coord_t EnhancedCandleStick::price_line_y = -1;
+lv_obj_t *EnhancedCandleStick::min_label = NULL;
+lv_obj_t *EnhancedCandleStick::max_label = NULL;
+lv_obj_t *EnhancedCandleStick::price_label = NULL;
+lv_obj_t *EnhancedCandleStick::high_label = NULL;
+lv_obj_t *EnhancedCandleStick::low_label = NULL;
+render_stats_t EnhancedCandleStick::stats = {0};
+bool EnhancedCandleStick::canvas_mode = false;
+lv_obj_t *EnhancedCandleStick::canvas = NULL;
+lv_color_t *EnhancedCandleStick::canvas_buf = NULL;
+size_t EnhancedCandleStick::canvas_buf_size = 0;
+
 lv_obj_t *EnhancedCandleStick::find_obj_by_id(lv_obj_t *parent, uint32_t id) {
   if (parent == NULL)
     return NULL;
@@ -22,6 +46,7 @@ lv_obj_t *EnhancedCandleStick::find_obj_by_id(lv_obj_t *parent, uint32_t id) {
 }
 
 void EnhancedCandleStick::create(lv_obj_t *parent, const String &symbol) {
+  uint32_t start = Metrics::cycles();
   lv_obj_t *chart_container = (lv_obj_t *)lv_obj_get_user_data(parent);
   if (chart_container == NULL) {
     return;
@@ -44,22 +69,17 @@ void EnhancedCandleStick::create(lv_obj_t *parent, const String &symbol) {
     }
   }
 
-  // Clean the container
+  // Clean the container; every retained object goes with it
   lv_obj_clean(chart_container);
   lv_obj_set_style_bg_color(chart_container, lv_color_black(), 0);
+  release_pools();
+  container = chart_container;
+  stats.rebuilds++;
 
-  // Get data from DataFetcher
-  enhanced_candle_t *candles = DataFetcher::getCandles();
   int num_candles = DataFetcher::getCandleCount();
-  int newest_index = DataFetcher::getNewestIndex();
-  float current_price = DataFetcher::getCurrentPrice();
 
-  // Debug output for bars calculation
-  Serial.printf("=== BARS DISPLAY DEBUG ===\n");
-  Serial.printf("BARS_TO_SHOW config: %d\n", BARS_TO_SHOW);
-  Serial.printf("Available candles: %d\n", num_candles);
-  Serial.printf("MAX_CANDLES limit: %d\n", MAX_CANDLES);
-  Serial.printf("Newest index: %d\n", newest_index);
+  LOG_D("Chart rebuild: BARS_TO_SHOW %d, %d candles, capacity %d",
+        BARS_TO_SHOW, num_candles, DataFetcher::getStore().capacity());
 
   if (num_candles == 0) {
     // No data available, show loading message
@@ -67,100 +87,25 @@ void EnhancedCandleStick::create(lv_obj_t *parent, const String &symbol) {
     lv_label_set_text(loading_label, "Loading...");
     lv_obj_center(loading_label);
     lv_obj_set_style_text_color(loading_label, lv_color_white(), 0);
-    Serial.println("No data available, showing loading message");
+    LOG_D("No data available, showing loading message");
     return;
   }
 
-  // Calculate how many bars to show and ensure it doesn't exceed available data
-  int barsToShow = std::min(BARS_TO_SHOW, num_candles);
-  Serial.printf("Actual bars to display: %d (limited by %s)\n", barsToShow,
-                (barsToShow == BARS_TO_SHOW) ? "config" : "available data");
-
-  // FIXED: Calculate price levels manually here instead of using the function
-  float min_price = std::numeric_limits<float>::max();
-  float max_price = std::numeric_limits<float>::lowest();
-
-  Serial.printf("=== PRICE RANGE DEBUG ===\n");
-  Serial.printf("Calculating price range for %d most recent bars:\n",
-                barsToShow);
-
-  // Get the most recent barsToShow candles
-  for (int i = 0; i < barsToShow; i++) {
-    // Get the i-th most recent candle
-    int index = (newest_index - i + MAX_CANDLES) % MAX_CANDLES;
-    const enhanced_candle_t &candle = candles[index];
-
-    // // Debug first 5 and last 5 candles
-    // if (i < 5 || i >= barsToShow - 5) {
-    //     Serial.printf("  Bar %d: index=%d, high=%.2f, low=%.2f, open=%.2f,
-    //     close=%.2f\n",
-    //                  i, index, candle.high, candle.low, candle.open,
-    //                  candle.close);
-    // }
-
-    // Only include candles with valid data
-    if (candle.high > 0 && candle.low > 0 && candle.open > 0 &&
-        candle.close > 0) {
-      min_price = std::min(min_price, candle.low);
-      max_price = std::max(max_price, candle.high);
-    } else {
-      Serial.printf("  WARNING: Invalid data at index %d\n", index);
-    }
-  }
-
-  // Handle case where no valid data found
-  if (min_price == std::numeric_limits<float>::max()) {
-    Serial.println("ERROR: No valid price data found!");
-    min_price = 0;
-    max_price = 100;
-  }
-
-  // Serial.printf("Raw price range: %.2f - %.2f\n", min_price, max_price);
-
-  // Add padding for drawing (10% padding)
-  float range = max_price - min_price;
-  if (range == 0)
-    range = 1.0f; // Prevent division by zero
-  float padding = range * 0.1f;
-  float draw_min = std::max(min_price - padding, 0.0f);
-  float draw_max = max_price + padding;
-
-  // Serial.printf("Display range with padding: %.2f - %.2f\n", draw_min,
-  // draw_max);
-
-  // Draw grid lines with the visible range
-  draw_price_gridlines(chart_container, draw_min, draw_max);
-
-  // Draw candlesticks - display them in chronological order (oldest to newest,
-  // left to right) Serial.printf("Drawing %d candlesticks in chronological
-  // order:\n", barsToShow);
-  for (int displayPos = 0; displayPos < barsToShow; displayPos++) {
-    // Calculate which candle to show at this display position
-    // displayPos 0 = oldest of the recent bars (newest_index - barsToShow + 1)
-    // displayPos barsToShow-1 = newest bar (newest_index)
-    int candleAge =
-        barsToShow - displayPos - 1; // How many bars back from newest
-    int dataIndex = (newest_index - candleAge + MAX_CANDLES) % MAX_CANDLES;
-
-    // Debug first few bars
-    if (displayPos < 3) {
-      const enhanced_candle_t &debugCandle = candles[dataIndex];
-      // Serial.printf("  Display pos %d: age=%d, dataIndex=%d, close=%.2f\n",
-      //              displayPos, candleAge, dataIndex, debugCandle.close);
-    }
-
-    draw_candlestick(chart_container, displayPos, candles[dataIndex], draw_min,
-                     draw_max, barsToShow);
-  }
-
-  // Draw current price line
-  if (current_price > 0) {
-    draw_current_price_line(chart_container, current_price, draw_min, draw_max);
+  // Gridlines, candles and the price line, in back-to-front order, either
+  // as retained objects or rasterized into a single canvas. Pools are sized
+  // for the configured width up front; while fewer bars are held, render()
+  // leaves the spare slots hidden instead of rebuilding as each bar lands.
+  canvas_mode = USE_CANVAS_RENDERER;
+  bool allocated = canvas_mode ? allocate_canvas(chart_container)
+                               : allocate_pools(chart_container, BARS_TO_SHOW);
+  if (!allocated) {
+    LOG_E("Not enough memory for candle renderer");
+    return;
   }
+  pool_size = BARS_TO_SHOW;
 
-  // Create info panel with visible range min/max
-  create_info_panel(chart_container, symbol, current_price, min_price,
-                    max_price);
+  // Info panel sits above the chart
+  create_info_panel(chart_container, symbol);
 
   // Restore time and date labels
   lv_obj_t *new_info_panel = find_obj_by_id(chart_container, INFO_PANEL_ID);
@@ -183,15 +128,9 @@ void EnhancedCandleStick::create(lv_obj_t *parent, const String &symbol) {
   }
 
   // Add price labels on the left (using visible range)
-  char min_price_str[16], max_price_str[16];
-  snprintf(min_price_str, sizeof(min_price_str), "%.2f", min_price);
-  snprintf(max_price_str, sizeof(max_price_str), "%.2f", max_price);
-
-  lv_obj_t *min_label = lv_label_create(chart_container);
-  lv_obj_t *max_label = lv_label_create(chart_container);
-
-  lv_label_set_text(min_label, min_price_str);
-  lv_label_set_text(max_label, max_price_str);
+  min_label = lv_label_create(chart_container);
+  max_label = lv_label_create(chart_container);
+  stats.objects_created += 2;
 
   lv_obj_align(min_label, LV_ALIGN_BOTTOM_LEFT, 5, -5);
   lv_obj_align(max_label, LV_ALIGN_TOP_LEFT, 5, 5);
@@ -199,23 +138,30 @@ void EnhancedCandleStick::create(lv_obj_t *parent, const String &symbol) {
   lv_obj_set_style_text_color(min_label, lv_color_white(), 0);
   lv_obj_set_style_text_color(max_label, lv_color_white(), 0);
 
-  // Serial.printf("Chart creation complete. Displayed %d bars with range %.2f -
-  // %.2f\n",
-  //               barsToShow, min_price, max_price);
-  Serial.printf("=========================\n");
+  render(symbol);
 
   lv_task_handler();
+  Metrics::recordSince(METRIC_CHART_REBUILD, start);
 }
 
 void EnhancedCandleStick::update(lv_obj_t *parent, const String &symbol) {
   static bool market_closed_border = false;
+  uint32_t start = Metrics::cycles();
 
   // Check market hours
   bool is_market_open = USE_TEST_DATA || !ENFORCE_MARKET_HOURS ||
                         StockTracker::MarketHoursChecker::isMarketOpen();
 
-  // Update the chart
-  create(parent, symbol);
+  // Rebuild only when the object pools no longer match the configured
+  // width; otherwise just move, recolor, show or hide what changed
+  lv_obj_t *current_container = (lv_obj_t *)lv_obj_get_user_data(parent);
+  if (pool_size == 0 || pool_size != BARS_TO_SHOW ||
+      DataFetcher::getCandleCount() == 0 || container != current_container ||
+      canvas_mode != USE_CANVAS_RENDERER) {
+    create(parent, symbol);
+  } else {
+    render(symbol);
+  }
 
   // Get the chart container for market status indication
   lv_obj_t *chart_container = (lv_obj_t *)lv_obj_get_user_data(parent);
@@ -258,6 +204,7 @@ void EnhancedCandleStick::update(lv_obj_t *parent, const String &symbol) {
     // Update info panel with current configuration
     update_info_panel(chart_container, symbol);
   }
+  Metrics::recordSince(METRIC_CHART_UPDATE, start);
 }
 
 void EnhancedCandleStick::update_info_panel(lv_obj_t *chart_container,
@@ -276,17 +223,263 @@ void EnhancedCandleStick::update_info_panel(lv_obj_t *chart_container,
     lv_obj_align(interval_label, LV_ALIGN_BOTTOM_MID, 0, -10);
   }
 
-  String interval_text = YAHOO_INTERVAL + "/" + YAHOO_RANGE;
-  lv_label_set_text(interval_label, interval_text.c_str());
+  // Runs on every update; the label is only touched when the text changes
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%s/%s", YAHOO_INTERVAL.c_str(),
+           YAHOO_RANGE.c_str());
+  set_label_text(interval_label, buf);
+}
+
+lv_obj_t *EnhancedCandleStick::create_rect(lv_obj_t *parent) {
+  lv_obj_t *rect = lv_obj_create(parent);
+  lv_obj_set_style_bg_opa(rect, LV_OPA_COVER, 0);
+  lv_obj_set_style_border_width(rect, 0, 0);
+  lv_obj_set_align(rect, LV_ALIGN_TOP_LEFT);
+  stats.objects_created++;
+  return rect;
+}
+
+void EnhancedCandleStick::release_pools() {
+  // The LVGL objects themselves are deleted by lv_obj_clean()
+  free(wick_pool);
+  free(body_pool);
+  free(geom_cache);
+  wick_pool = NULL;
+  body_pool = NULL;
+  geom_cache = NULL;
+  pool_size = 0;
+
+  for (int i = 0; i < MAX_GRIDLINES; i++) {
+    grid_pool[i] = NULL;
+  }
+  price_line = NULL;
+  canvas = NULL; // Its buffer is kept for the next canvas rebuild
+  min_label = NULL;
+  max_label = NULL;
+  price_label = NULL;
+  high_label = NULL;
+  low_label = NULL;
+  container = NULL;
+}
+
+bool EnhancedCandleStick::allocate_pools(lv_obj_t *parent, int bars) {
+  wick_pool = (lv_obj_t **)malloc(bars * sizeof(lv_obj_t *));
+  body_pool = (lv_obj_t **)malloc(bars * sizeof(lv_obj_t *));
+  geom_cache = (candle_geom_t *)malloc(bars * sizeof(candle_geom_t));
+  if (wick_pool == NULL || body_pool == NULL || geom_cache == NULL) {
+    release_pools();
+    return false;
+  }
+
+  lv_color_t grid_color = lv_color_make(100, 100, 100);
+  for (int i = 0; i < MAX_GRIDLINES; i++) {
+    grid_pool[i] = create_rect(parent);
+    lv_obj_set_style_bg_color(grid_pool[i], grid_color, 0);
+    lv_obj_set_style_bg_opa(grid_pool[i], LV_OPA_50, 0);
+    lv_obj_add_flag(grid_pool[i], LV_OBJ_FLAG_HIDDEN);
+    grid_y[i] = -1;
+  }
+
+  for (int i = 0; i < bars; i++) {
+    wick_pool[i] = create_rect(parent);
+    body_pool[i] = create_rect(parent);
+    // Hidden until a render places a bar in the slot
+    lv_obj_add_flag(wick_pool[i], LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_flag(body_pool[i], LV_OBJ_FLAG_HIDDEN);
+    geom_cache[i].x = -1;
+  }
+
+  price_line = create_rect(parent);
+  lv_obj_set_style_bg_color(price_line, lv_color_make(0, 255, 255), 0);
+  lv_obj_set_style_bg_opa(price_line, LV_OPA_70, 0);
+  lv_obj_add_flag(price_line, LV_OBJ_FLAG_HIDDEN);
+  price_line_y = -1;
+
+  return true;
 }
 
-void EnhancedCandleStick::draw_candlestick(lv_obj_t *parent, int index,
-                                           const enhanced_candle_t &candle,
-                                           float min_price, float max_price,
-                                           int total_bars) {
+bool EnhancedCandleStick::allocate_canvas(lv_obj_t *parent) {
   lv_coord_t chart_width = lv_obj_get_width(parent) - INFO_PANEL_WIDTH;
   lv_coord_t chart_height = lv_obj_get_height(parent);
+  size_t needed = LV_CANVAS_BUF_SIZE_TRUE_COLOR(chart_width, chart_height);
+
+  if (canvas_buf_size < needed) {
+    free(canvas_buf);
+    canvas_buf = (lv_color_t *)ps_malloc(needed);
+    canvas_buf_size = (canvas_buf != NULL) ? needed : 0;
+    if (canvas_buf == NULL) {
+      return false;
+    }
+  }
+
+  canvas = lv_canvas_create(parent);
+  lv_canvas_set_buffer(canvas, canvas_buf, chart_width, chart_height,
+                       LV_IMG_CF_TRUE_COLOR);
+  lv_obj_align(canvas, LV_ALIGN_TOP_LEFT, 0, 0);
+  stats.objects_created++;
+  return true;
+}
+
+void EnhancedCandleStick::render(const String &symbol) {
+  if (container == NULL || pool_size == 0) {
+    return;
+  }
+
+  unsigned long render_start = micros();
+  uint32_t touched = 0;
+
+  int barsToShow = std::min(pool_size, DataFetcher::getCandleCount());
+  float current_price = DataFetcher::getCurrentPrice();
+
+  float min_price, max_price, draw_min, draw_max;
+  compute_visible_range(barsToShow, &min_price, &max_price, &draw_min,
+                        &draw_max);
+
+  if (canvas_mode) {
+    touched += render_canvas(barsToShow, draw_min, draw_max);
+  } else {
+    touched += render_objects(barsToShow, draw_min, draw_max);
+  }
+
+  // Labels only change text when the value does
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.2f", min_price);
+  touched += set_label_text(min_label, buf);
+  snprintf(buf, sizeof(buf), "%.2f", max_price);
+  touched += set_label_text(max_label, buf);
+  snprintf(buf, sizeof(buf), "%.2f", current_price);
+  touched += set_label_text(price_label, buf);
+  snprintf(buf, sizeof(buf), "H: %.2f", max_price);
+  touched += set_label_text(high_label, buf);
+  snprintf(buf, sizeof(buf), "L: %.2f", min_price);
+  touched += set_label_text(low_label, buf);
+
+  uint32_t elapsed = micros() - render_start;
+  stats.renders++;
+  stats.objects_touched = touched;
+  stats.last_render_us = elapsed;
+  stats.max_render_us = std::max(stats.max_render_us, elapsed);
+
+  LOG_V("Render (%s): %u objects touched, %u created total, %u us",
+        canvas_mode ? "canvas" : "objects", touched, stats.objects_created,
+        elapsed);
+}
+
+void EnhancedCandleStick::compute_visible_range(int bars, float *min_price,
+                                                float *max_price,
+                                                float *draw_min,
+                                                float *draw_max) {
+  // O(log n) lookup in the fetcher's extrema index, no per-bar scan
+  if (!DataFetcher::getVisibleExtrema(bars, min_price, max_price)) {
+    LOG_E("No valid price data found!");
+    *min_price = 0;
+    *max_price = 100;
+  }
+
+  // Add padding for drawing (10% padding)
+  float range = *max_price - *min_price;
+  if (range == 0)
+    range = 1.0f; // Prevent division by zero
+  float padding = range * 0.1f;
+  *draw_min = std::max(*min_price - padding, 0.0f);
+  *draw_max = *max_price + padding;
+}
+
+uint32_t EnhancedCandleStick::render_objects(int bars, float draw_min,
+                                             float draw_max) {
+  lv_coord_t chart_width = lv_obj_get_width(container) - INFO_PANEL_WIDTH;
+  lv_coord_t chart_height = lv_obj_get_height(container);
+  uint32_t touched = 0;
+
+  // Grid lines with the visible range
+  touched += layout_price_gridlines(draw_min, draw_max);
+
+  // Candles in chronological order (oldest to newest, left to right). Only
+  // the ones whose pixels moved are touched, usually just the newest.
+  for (int displayPos = 0; displayPos < bars; displayPos++) {
+    int candleAge = bars - displayPos - 1; // How many bars back from newest
 
+    candle_geom_t geom;
+    layout_candle(&geom, displayPos, DataFetcher::getCandle(candleAge),
+                  draw_min, draw_max, bars, chart_width, chart_height);
+    touched += apply_candle(displayPos, geom);
+  }
+
+  // Slots past the bars held hide again if the series ever gets shorter
+  for (int i = bars; i < pool_size; i++) {
+    if (geom_cache[i].x >= 0) {
+      lv_obj_add_flag(wick_pool[i], LV_OBJ_FLAG_HIDDEN);
+      lv_obj_add_flag(body_pool[i], LV_OBJ_FLAG_HIDDEN);
+      geom_cache[i].x = -1;
+      touched += 2;
+    }
+  }
+
+  // Current price line
+  touched += layout_current_price_line(DataFetcher::getCurrentPrice(),
+                                       draw_min, draw_max);
+  return touched;
+}
+
+uint32_t EnhancedCandleStick::render_canvas(int bars, float draw_min,
+                                            float draw_max) {
+  float current_price = DataFetcher::getCurrentPrice();
+  lv_coord_t width = lv_obj_get_width(container) - INFO_PANEL_WIDTH;
+  lv_coord_t height = lv_obj_get_height(container);
+
+  CandleRasterizer::clear(canvas_buf, width, height, lv_color_black());
+
+  // Gridlines at the same prices the object renderer uses, pre-blended
+  // against the black background
+  float price_range = draw_max - draw_min;
+  float grid_interval = grid_interval_for(price_range);
+  lv_color_t grid_color = lv_color_mix(lv_color_make(100, 100, 100),
+                                       lv_color_black(), LV_OPA_50);
+  float first_line = ceil(draw_min / grid_interval) * grid_interval;
+  int line = 0;
+  for (float price = first_line; price <= draw_max && line < MAX_GRIDLINES;
+       price += grid_interval, line++) {
+    int y_pos = height * (1.0f - (price - draw_min) / price_range);
+    y_pos = constrain(y_pos, 0, height);
+    CandleRasterizer::fillRect(canvas_buf, width, height, 0, y_pos, width, 1,
+                               grid_color);
+  }
+
+  // One vertical span per wick, one filled rect per body
+  lv_color_t up_color = lv_color_make(0, 255, 0);
+  lv_color_t down_color = lv_color_make(255, 0, 0);
+  for (int displayPos = 0; displayPos < bars; displayPos++) {
+    int candleAge = bars - displayPos - 1;
+
+    candle_geom_t geom;
+    layout_candle(&geom, displayPos, DataFetcher::getCandle(candleAge),
+                  draw_min, draw_max, bars, width, height);
+    lv_color_t color = geom.up ? up_color : down_color;
+    CandleRasterizer::fillRect(canvas_buf, width, height,
+                               geom.x + geom.width / 2, geom.wick_y, 1,
+                               geom.wick_h, color);
+    CandleRasterizer::fillRect(canvas_buf, width, height, geom.x, geom.body_y,
+                               geom.width, geom.body_h, color);
+  }
+
+  // Current price line, blended over the candles like the object version
+  if (current_price > 0) {
+    int y_current =
+        height * (1.0f - (current_price - draw_min) / price_range);
+    y_current = constrain(y_current, 0, height);
+    CandleRasterizer::blendRect(canvas_buf, width, height, 0, y_current, width,
+                                2, lv_color_make(0, 255, 255), LV_OPA_70);
+  }
+
+  lv_obj_invalidate(canvas);
+  return 1;
+}
+
+void EnhancedCandleStick::layout_candle(candle_geom_t *geom, int index,
+                                        const enhanced_candle_t &candle,
+                                        float min_price, float max_price,
+                                        int total_bars, lv_coord_t chart_width,
+                                        lv_coord_t chart_height) {
   // FIXED: Proper bar width calculation that allows 1-pixel candles
   int candle_width, spacing;
 
@@ -295,12 +488,8 @@ void EnhancedCandleStick::draw_candlestick(lv_obj_t *parent, int index,
     candle_width = chart_width / total_bars;
     spacing = 0;
   } else {
-    // With padding: calculate optimal width and spacing
-    // Available space = chart_width
-    // Formula: total_bars * candle_width + (total_bars - 1) * padding =
-    // chart_width Solve for candle_width: candle_width = (chart_width -
-    // (total_bars - 1) * padding) / total_bars
-
+    // With padding: total_bars * candle_width + (total_bars - 1) * padding
+    // = chart_width, solved for candle_width
     int total_padding_space = (total_bars - 1) * CANDLE_PADDING;
     candle_width = (chart_width - total_padding_space) / total_bars;
     spacing = CANDLE_PADDING;
@@ -317,16 +506,6 @@ void EnhancedCandleStick::draw_candlestick(lv_obj_t *parent, int index,
   // Ensure minimum candle width of 1 pixel
   candle_width = std::max(1, candle_width);
 
-  // Calculate position
-  int x = index * (candle_width + spacing);
-
-  // Debug output for first few candles
-  if (index < 3) {
-    Serial.printf(
-        "Bar %d: width=%d, spacing=%d, x=%d, total_bars=%d, chart_width=%d\n",
-        index, candle_width, spacing, x, total_bars, chart_width);
-  }
-
   // Calculate Y positions
   int y_top = chart_height *
               (1.0f - (candle.high - min_price) / (max_price - min_price));
@@ -342,98 +521,161 @@ void EnhancedCandleStick::draw_candlestick(lv_obj_t *parent, int index,
   y_open = constrain(y_open, 0, chart_height);
   y_close = constrain(y_close, 0, chart_height);
 
-  // SIMPLIFIED Color coding: ONLY green for up, red for down - NO ORANGE
-  lv_color_t candle_color =
-      (candle.close >= candle.open) ? lv_color_make(0, 255, 0) : // Green for up
-          lv_color_make(255, 0, 0);                              // Red for down
-
-  // Draw wick (always 1 pixel wide, centered)
-  lv_obj_t *wick = lv_obj_create(parent);
-  lv_obj_set_size(wick, 1, y_bottom - y_top);
-  lv_obj_set_style_bg_color(wick, candle_color, 0);
-  lv_obj_set_style_bg_opa(wick, LV_OPA_COVER, 0);
-  lv_obj_set_style_border_width(wick, 0, 0);
-  lv_obj_align(wick, LV_ALIGN_TOP_LEFT, x + (candle_width / 2), y_top);
-
-  // Draw body
-  lv_obj_t *body = lv_obj_create(parent);
-  int body_y = (y_open < y_close) ? y_open : y_close;
   int body_height = abs(y_close - y_open);
   if (body_height < 1)
     body_height = 1; // Minimum height for doji candles
 
-  lv_obj_set_size(body, candle_width, body_height);
-  lv_obj_set_style_bg_color(body, candle_color, 0);
-  lv_obj_set_style_bg_opa(body, LV_OPA_COVER, 0);
-  lv_obj_set_style_border_width(body, 0, 0);
-  lv_obj_align(body, LV_ALIGN_TOP_LEFT, x, body_y);
+  geom->x = index * (candle_width + spacing);
+  geom->width = candle_width;
+  geom->wick_y = y_top;
+  geom->wick_h = y_bottom - y_top;
+  geom->body_y = std::min(y_open, y_close);
+  geom->body_h = body_height;
+  geom->up = candle.close >= candle.open;
 }
 
-void EnhancedCandleStick::draw_current_price_line(lv_obj_t *parent,
-                                                  float current_price,
-                                                  float min_price,
-                                                  float max_price) {
-  lv_coord_t chart_width = lv_obj_get_width(parent) - INFO_PANEL_WIDTH;
-  lv_coord_t chart_height = lv_obj_get_height(parent);
+uint32_t EnhancedCandleStick::apply_candle(int index,
+                                           const candle_geom_t &geom) {
+  candle_geom_t &cached = geom_cache[index];
+  lv_obj_t *wick = wick_pool[index];
+  lv_obj_t *body = body_pool[index];
+  bool first = cached.x < 0; // Hidden, or never placed
+  bool wick_touched = false;
+  bool body_touched = false;
+
+  if (first) {
+    lv_obj_clear_flag(wick, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(body, LV_OBJ_FLAG_HIDDEN);
+  }
+
+  // SIMPLIFIED Color coding: ONLY green for up, red for down - NO ORANGE
+  if (first || cached.up != geom.up) {
+    lv_color_t candle_color = geom.up ? lv_color_make(0, 255, 0)
+                                      : lv_color_make(255, 0, 0);
+    lv_obj_set_style_bg_color(wick, candle_color, 0);
+    lv_obj_set_style_bg_color(body, candle_color, 0);
+    wick_touched = body_touched = true;
+  }
+
+  // Wick (always 1 pixel wide, centered)
+  if (first || cached.x != geom.x || cached.width != geom.width ||
+      cached.wick_y != geom.wick_y || cached.wick_h != geom.wick_h) {
+    lv_obj_set_size(wick, 1, geom.wick_h);
+    lv_obj_set_pos(wick, geom.x + (geom.width / 2), geom.wick_y);
+    wick_touched = true;
+  }
+
+  // Body
+  if (first || cached.x != geom.x || cached.width != geom.width ||
+      cached.body_y != geom.body_y || cached.body_h != geom.body_h) {
+    lv_obj_set_size(body, geom.width, geom.body_h);
+    lv_obj_set_pos(body, geom.x, geom.body_y);
+    body_touched = true;
+  }
+
+  cached = geom;
+  return (wick_touched ? 1 : 0) + (body_touched ? 1 : 0);
+}
+
+uint32_t EnhancedCandleStick::layout_current_price_line(float current_price,
+                                                        float min_price,
+                                                        float max_price) {
+  if (current_price <= 0) {
+    if (price_line_y >= 0) {
+      lv_obj_add_flag(price_line, LV_OBJ_FLAG_HIDDEN);
+      price_line_y = -1;
+      return 1;
+    }
+    return 0;
+  }
+
+  lv_coord_t chart_width = lv_obj_get_width(container) - INFO_PANEL_WIDTH;
+  lv_coord_t chart_height = lv_obj_get_height(container);
 
   int y_current = chart_height * (1.0f - (current_price - min_price) /
                                              (max_price - min_price));
   y_current = constrain(y_current, 0, chart_height);
 
-  lv_obj_t *price_line = lv_obj_create(parent);
-  lv_obj_set_size(price_line, chart_width, 2);
-  lv_obj_set_style_bg_color(price_line, lv_color_make(0, 255, 255), 0);
-  lv_obj_set_style_bg_opa(price_line, LV_OPA_70, 0);
-  lv_obj_set_style_border_width(price_line, 0, 0);
-  lv_obj_align(price_line, LV_ALIGN_TOP_LEFT, 0, y_current);
-}
+  if (y_current == price_line_y) {
+    return 0;
+  }
 
-void EnhancedCandleStick::draw_price_gridlines(lv_obj_t *parent,
-                                               float min_price,
-                                               float max_price) {
-  lv_coord_t chart_width = lv_obj_get_width(parent) - INFO_PANEL_WIDTH;
-  lv_coord_t chart_height = lv_obj_get_height(parent);
+  if (price_line_y < 0) {
+    lv_obj_set_size(price_line, chart_width, 2);
+    lv_obj_clear_flag(price_line, LV_OBJ_FLAG_HIDDEN);
+  }
+  lv_obj_set_pos(price_line, 0, y_current);
+  price_line_y = y_current;
+  return 1;
+}
 
+float EnhancedCandleStick::grid_interval_for(float price_range) {
   // FIXED: Use a more intelligent grid calculation
-  float price_range = max_price - min_price;
-  float grid_interval;
-
   // Calculate appropriate grid interval based on price range
   if (price_range > 100) {
-    grid_interval = 10.0f;
+    return 10.0f;
   } else if (price_range > 50) {
-    grid_interval = 5.0f;
+    return 5.0f;
   } else if (price_range > 10) {
-    grid_interval = 1.0f;
+    return 1.0f;
   } else if (price_range > 1) {
-    grid_interval = 0.5f;
-  } else {
-    grid_interval = 0.1f;
+    return 0.5f;
   }
+  return 0.1f;
+}
+
+uint32_t EnhancedCandleStick::layout_price_gridlines(float min_price,
+                                                     float max_price) {
+  lv_coord_t chart_width = lv_obj_get_width(container) - INFO_PANEL_WIDTH;
+  lv_coord_t chart_height = lv_obj_get_height(container);
+
+  float grid_interval = grid_interval_for(max_price - min_price);
 
   // Find first grid line
   float first_line = ceil(min_price / grid_interval) * grid_interval;
 
-  lv_color_t grid_color = lv_color_make(100, 100, 100);
-
-  for (float price = first_line; price <= max_price; price += grid_interval) {
+  uint32_t touched = 0;
+  int line = 0;
+  for (float price = first_line; price <= max_price && line < MAX_GRIDLINES;
+       price += grid_interval, line++) {
     int y_pos =
         chart_height * (1.0f - (price - min_price) / (max_price - min_price));
     y_pos = constrain(y_pos, 0, chart_height);
 
-    lv_obj_t *grid_line = lv_obj_create(parent);
-    lv_obj_set_size(grid_line, chart_width, 1);
-    lv_obj_set_style_bg_color(grid_line, grid_color, 0);
-    lv_obj_set_style_bg_opa(grid_line, LV_OPA_50, 0);
-    lv_obj_set_style_border_width(grid_line, 0, 0);
-    lv_obj_align(grid_line, LV_ALIGN_TOP_LEFT, 0, y_pos);
+    if (grid_y[line] == y_pos) {
+      continue;
+    }
+    if (grid_y[line] < 0) {
+      lv_obj_set_size(grid_pool[line], chart_width, 1);
+      lv_obj_clear_flag(grid_pool[line], LV_OBJ_FLAG_HIDDEN);
+    }
+    lv_obj_set_pos(grid_pool[line], 0, y_pos);
+    grid_y[line] = y_pos;
+    touched++;
+  }
+
+  // Hide whatever the previous range used beyond this one
+  for (; line < MAX_GRIDLINES && grid_y[line] >= 0; line++) {
+    lv_obj_add_flag(grid_pool[line], LV_OBJ_FLAG_HIDDEN);
+    grid_y[line] = -1;
+    touched++;
   }
+
+  return touched;
+}
+
+uint32_t EnhancedCandleStick::set_label_text(lv_obj_t *label,
+                                             const char *text) {
+  // lv_label_set_text invalidates even when the text is identical
+  if (label == NULL || strcmp(lv_label_get_text(label), text) == 0) {
+    return 0;
+  }
+  lv_label_set_text(label, text);
+  return 1;
 }
 
 void EnhancedCandleStick::create_info_panel(lv_obj_t *parent,
-                                            const String &symbol,
-                                            float current_price,
-                                            float min_price, float max_price) {
+                                            const String &symbol) {
   lv_coord_t chart_height = lv_obj_get_height(parent);
 
   lv_obj_t *info_panel = lv_obj_create(parent);
@@ -452,26 +694,20 @@ void EnhancedCandleStick::create_info_panel(lv_obj_t *parent,
   lv_obj_set_style_text_font(symbol_label, &lv_font_montserrat_16, 0);
   lv_obj_set_user_data(symbol_label, (void *)SYMBOL_LABEL_ID);
 
-  // Current price label
-  lv_obj_t *price_label = lv_label_create(info_panel);
-  char price_buf[16];
-  snprintf(price_buf, sizeof(price_buf), "%.2f", current_price);
-  lv_label_set_text(price_label, price_buf);
+  // Current price label; text is filled in by render()
+  price_label = lv_label_create(info_panel);
+  lv_label_set_text(price_label, "");
   lv_obj_align(price_label, LV_ALIGN_TOP_MID, 0, 40);
   lv_obj_set_style_text_color(price_label, lv_color_make(0, 255, 255), 0);
   lv_obj_set_style_text_font(price_label, &lv_font_montserrat_16, 0);
   lv_obj_set_user_data(price_label, (void *)PRICE_LABEL_ID);
 
   // High/Low labels (using visible range)
-  lv_obj_t *high_label = lv_label_create(info_panel);
-  lv_obj_t *low_label = lv_label_create(info_panel);
-
-  char high_buf[32], low_buf[32];
-  snprintf(high_buf, sizeof(high_buf), "H: %.2f", max_price);
-  snprintf(low_buf, sizeof(low_buf), "L: %.2f", min_price);
+  high_label = lv_label_create(info_panel);
+  low_label = lv_label_create(info_panel);
 
-  lv_label_set_text(high_label, high_buf);
-  lv_label_set_text(low_label, low_buf);
+  lv_label_set_text(high_label, "");
+  lv_label_set_text(low_label, "");
 
   lv_obj_align(high_label, LV_ALIGN_TOP_MID, 0, 75);
   lv_obj_align(low_label, LV_ALIGN_TOP_MID, 0, 95);
@@ -481,4 +717,6 @@ void EnhancedCandleStick::create_info_panel(lv_obj_t *parent,
 
   lv_obj_set_user_data(high_label, (void *)HIGH_LABEL_ID);
   lv_obj_set_user_data(low_label, (void *)LOW_LABEL_ID);
-}
\ No newline at end of file
+
+  stats.objects_created += 5;
+}
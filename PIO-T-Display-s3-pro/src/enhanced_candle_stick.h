@@ -6,6 +6,7 @@
 
 #define CANDLE_PADDING 0
 #define INFO_PANEL_WIDTH 80
+#define MAX_GRIDLINES 32
 
 // Define IDs for our user data objects
 #define INFO_PANEL_ID 0x1001
@@ -18,21 +19,77 @@
 #define STATUS_LABEL_ID 0x1008
 #define INTERVAL_LABEL_ID 0x1009
 
+// Pixel placement of one candle; cached so unchanged bars are not touched
+typedef struct {
+    lv_coord_t x;
+    lv_coord_t width;
+    lv_coord_t wick_y;
+    lv_coord_t wick_h;
+    lv_coord_t body_y;
+    lv_coord_t body_h;
+    bool up;
+} candle_geom_t;
+
+typedef struct {
+    uint32_t renders;         // Retained updates since boot
+    uint32_t rebuilds;        // Full create() passes since boot
+    uint32_t objects_created; // LVGL objects allocated since boot
+    uint32_t objects_touched; // Objects moved/recolored by the last update
+    uint32_t last_render_us;
+    uint32_t max_render_us;
+} render_stats_t;
+
 class EnhancedCandleStick {
 private:
+    // Retained objects, allocated by create() and mutated by render()
+    static lv_obj_t *container;
+    static lv_obj_t **wick_pool;
+    static lv_obj_t **body_pool;
+    static candle_geom_t *geom_cache;
+    static int pool_size;
+    static lv_obj_t *grid_pool[MAX_GRIDLINES];
+    static lv_coord_t grid_y[MAX_GRIDLINES];
+    static lv_obj_t *price_line;
+    static lv_coord_t price_line_y;
+    static lv_obj_t *min_label;
+    static lv_obj_t *max_label;
+    static lv_obj_t *price_label;
+    static lv_obj_t *high_label;
+    static lv_obj_t *low_label;
+    static render_stats_t stats;
+
+    // Canvas mode: one bitmap instead of per-candle objects
+    static bool canvas_mode;
+    static lv_obj_t *canvas;
+    static lv_color_t *canvas_buf;
+    static size_t canvas_buf_size;
+
     static lv_obj_t* find_obj_by_id(lv_obj_t *parent, uint32_t id);
-    static void draw_candlestick(lv_obj_t *parent, int index, const enhanced_candle_t& candle, 
-                               float min_price, float max_price, int total_bars);  // Added total_bars parameter
-    static void draw_current_price_line(lv_obj_t *parent, float current_price, 
-                                      float min_price, float max_price);
-    static void draw_price_gridlines(lv_obj_t *parent, float min_price, float max_price);
-    static void create_info_panel(lv_obj_t *parent, const String& symbol, 
-                                float current_price, float min_price, float max_price);
+    static lv_obj_t* create_rect(lv_obj_t *parent);
+    static void release_pools();
+    static bool allocate_pools(lv_obj_t *parent, int bars);
+    static bool allocate_canvas(lv_obj_t *parent);
+    static void render(const String& symbol);
+    static void compute_visible_range(int bars, float *min_price, float *max_price,
+                                      float *draw_min, float *draw_max);
+    static uint32_t render_objects(int bars, float draw_min, float draw_max);
+    static uint32_t render_canvas(int bars, float draw_min, float draw_max);
+    static void layout_candle(candle_geom_t *geom, int index, const enhanced_candle_t& candle,
+                              float min_price, float max_price, int total_bars,
+                              lv_coord_t chart_width, lv_coord_t chart_height);
+    static uint32_t apply_candle(int index, const candle_geom_t& geom);
+    static uint32_t layout_current_price_line(float current_price,
+                                              float min_price, float max_price);
+    static float grid_interval_for(float price_range);
+    static uint32_t layout_price_gridlines(float min_price, float max_price);
+    static uint32_t set_label_text(lv_obj_t *label, const char *text);
+    static void create_info_panel(lv_obj_t *parent, const String& symbol);
     static void update_info_panel(lv_obj_t *chart_container, const String& symbol);
 
 public:
     static void create(lv_obj_t *parent, const String& symbol);
     static void update(lv_obj_t *parent, const String& symbol);
+    static const render_stats_t& getRenderStats() { return stats; }
 };
 
-#endif // ENHANCED_CANDLE_STICK_H
\ No newline at end of file
+#endif // ENHANCED_CANDLE_STICK_H
@@ -0,0 +1,146 @@
+#include "event_stream.h"
+#include "log.h"
+#include <errno.h>
+#include <lwip/sockets.h>
+
+// Static member definitions
+char EventStream::ring[EVENT_RING_DEPTH][EVENT_MESSAGE_CHARS];
+uint16_t EventStream::lengths[EVENT_RING_DEPTH];
+uint32_t EventStream::next_seq = 0;
+EventStream::event_client_t EventStream::clients[EVENT_STREAM_MAX_CLIENTS];
+unsigned long EventStream::last_publish = 0;
+event_stream_stats_t EventStream::stats = {0};
+
+bool EventStream::accept(WiFiClient client) {
+  event_client_t *slot = NULL;
+  for (int i = 0; i < EVENT_STREAM_MAX_CLIENTS; i++) {
+    if (!clients[i].active) {
+      slot = &clients[i];
+      break;
+    }
+  }
+
+  if (slot == NULL) {
+    client.print("HTTP/1.1 503 Service Unavailable\r\n"
+                 "Connection: close\r\nContent-Length: 0\r\n\r\n");
+    client.stop();
+    LOG_W("Event stream full, client refused");
+    return false;
+  }
+
+  // A fresh socket's send buffer takes this without waiting
+  client.setNoDelay(true);
+  client.print("HTTP/1.1 200 OK\r\n"
+               "Content-Type: text/event-stream\r\n"
+               "Cache-Control: no-cache\r\n"
+               "Connection: keep-alive\r\n"
+               "Access-Control-Allow-Origin: *\r\n\r\n"
+               "retry: 3000\n\n");
+
+  slot->client = client;
+  slot->active = true;
+  slot->sent = 0;
+  // Replay the newest message so the current bar shows straight away
+  slot->next = (next_seq > 0) ? next_seq - 1 : 0;
+  stats.clients_served++;
+
+  LOG_I("Event stream client %s connected",
+        client.remoteIP().toString().c_str());
+  return true;
+}
+
+void EventStream::push(const char *message, int len) {
+  int idx = next_seq % EVENT_RING_DEPTH;
+  memcpy(ring[idx], message, len);
+  lengths[idx] = len;
+  next_seq++;
+  last_publish = millis();
+}
+
+void EventStream::publish(const String &symbol,
+                          const enhanced_candle_t &candle, float price) {
+  // Formatted even with no listeners, so a new client starts current
+  char message[EVENT_MESSAGE_CHARS];
+  int len = snprintf(message, sizeof(message),
+                     "event: tick\ndata: {\"s\":\"%s\",\"t\":%ld,\"o\":%.4f,"
+                     "\"h\":%.4f,\"l\":%.4f,\"c\":%.4f,\"v\":%u,\"p\":%.4f,"
+                     "\"x\":%d}\n\n",
+                     symbol.c_str(), (long)candle.timestamp, candle.open,
+                     candle.high, candle.low, candle.close, candle.volume,
+                     price, candle.is_complete ? 1 : 0);
+  if (len <= 0 || len >= (int)sizeof(message)) {
+    return;
+  }
+
+  push(message, len);
+  stats.published++;
+}
+
+bool EventStream::flush(event_client_t &c) {
+  while (c.next != next_seq) {
+    uint32_t behind = next_seq - c.next;
+    if (behind > EVENT_RING_DEPTH) {
+      // The half-sent message is gone; resuming elsewhere would corrupt
+      // the stream, so the browser reconnects instead
+      if (c.sent > 0) {
+        return false;
+      }
+      stats.dropped += behind - EVENT_RING_DEPTH;
+      c.next = next_seq - EVENT_RING_DEPTH;
+    }
+
+    int idx = c.next % EVENT_RING_DEPTH;
+    int n = send(c.client.fd(), ring[idx] + c.sent, lengths[idx] - c.sent,
+                 MSG_DONTWAIT);
+    if (n < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    c.sent += n;
+    if (c.sent < lengths[idx]) {
+      return true; // TCP window is full; carry on next loop
+    }
+    c.sent = 0;
+    c.next++;
+  }
+  return true;
+}
+
+void EventStream::service() {
+  if (clientCount() == 0) {
+    return;
+  }
+
+  // Lets proxies and browsers tell an idle stream from a dead one
+  if (millis() - last_publish > EVENT_KEEPALIVE_MS) {
+    push(": ping\n\n", 8);
+  }
+
+  for (int i = 0; i < EVENT_STREAM_MAX_CLIENTS; i++) {
+    event_client_t &c = clients[i];
+    if (c.active && (!c.client.connected() || !flush(c))) {
+      LOG_I("Event stream client disconnected");
+      c.client.stop();
+      c.active = false;
+    }
+  }
+}
+
+void EventStream::closeAll() {
+  for (int i = 0; i < EVENT_STREAM_MAX_CLIENTS; i++) {
+    if (clients[i].active) {
+      clients[i].client.stop();
+      clients[i].active = false;
+    }
+  }
+}
+
+int EventStream::clientCount() {
+  int count = 0;
+  for (int i = 0; i < EVENT_STREAM_MAX_CLIENTS; i++) {
+    if (clients[i].active) {
+      count++;
+    }
+  }
+  return count;
+}
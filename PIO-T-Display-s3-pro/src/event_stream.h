@@ -0,0 +1,56 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include "candle_store.h"
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+#define EVENT_STREAM_MAX_CLIENTS 4
+#define EVENT_RING_DEPTH 16        // Messages a slow client may fall behind
+#define EVENT_MESSAGE_CHARS 192
+#define EVENT_KEEPALIVE_MS 15000   // Comment line when nothing else is sent
+
+typedef struct {
+  uint32_t published;
+  uint32_t dropped; // Messages clients missed by falling too far behind
+  uint32_t clients_served;
+} event_stream_stats_t;
+
+// Server-Sent Events for /events. Every tick is formatted once into a small
+// ring; each client only holds a cursor into it. A client that falls more
+// than EVENT_RING_DEPTH messages behind skips to the oldest one still held,
+// so the backlog per client is bounded and the oldest messages go first.
+// Sockets are written without blocking, a few bytes at a time if that is
+// all the TCP window takes. UI core only.
+class EventStream {
+private:
+  typedef struct {
+    WiFiClient client;
+    uint32_t next;  // Sequence number of the next message to send
+    uint16_t sent;  // Bytes of that message already written
+    bool active;
+  } event_client_t;
+
+  static char ring[EVENT_RING_DEPTH][EVENT_MESSAGE_CHARS];
+  static uint16_t lengths[EVENT_RING_DEPTH];
+  static uint32_t next_seq; // Sequence number the next publish gets
+  static event_client_t clients[EVENT_STREAM_MAX_CLIENTS];
+  static unsigned long last_publish;
+  static event_stream_stats_t stats;
+
+  static void push(const char *message, int len);
+  static bool flush(event_client_t &c);
+
+public:
+  // Takes over a connection whose request the web server has parsed
+  static bool accept(WiFiClient client);
+  static void publish(const String &symbol, const enhanced_candle_t &candle,
+                      float price);
+  // Writes whatever each client's socket can take right now
+  static void service();
+  static void closeAll();
+  static int clientCount();
+  static const event_stream_stats_t &getStats() { return stats; }
+};
+
+#endif // EVENT_STREAM_H
@@ -0,0 +1,77 @@
+#ifndef EXTREMA_TREE_H
+#define EXTREMA_TREE_H
+
+#include <algorithm>
+#include <limits>
+#include <stddef.h>
+
+// Bottom-up segment tree of per-slot low/high values. Slots map 1:1 onto a
+// ring buffer's indices; updating one slot and querying any slot range are
+// both O(log n). Empty slots hold (max, lowest) so they never win. The
+// owner provides the node storage, nodesFor(slots) elements per array.
+template <typename T = float> class ExtremaTree {
+private:
+  T *lows = NULL;
+  T *highs = NULL;
+  size_t leaves = 0;
+
+  static size_t leavesFor(size_t slots) {
+    size_t n = 1;
+    while (n < slots) {
+      n <<= 1;
+    }
+    return n;
+  }
+
+public:
+  static size_t nodesFor(size_t slots) { return 2 * leavesFor(slots); }
+
+  void attach(T *low_nodes, T *high_nodes, size_t slots) {
+    lows = low_nodes;
+    highs = high_nodes;
+    leaves = (lows != NULL && highs != NULL) ? leavesFor(slots) : 0;
+    clear();
+  }
+
+  void clear() {
+    std::fill(lows, lows + 2 * leaves, std::numeric_limits<T>::max());
+    std::fill(highs, highs + 2 * leaves, std::numeric_limits<T>::lowest());
+  }
+
+  void set(size_t slot, T low, T high) {
+    size_t i = slot + leaves;
+    lows[i] = low;
+    highs[i] = high;
+    for (i >>= 1; i >= 1; i >>= 1) {
+      lows[i] = std::min(lows[2 * i], lows[2 * i + 1]);
+      highs[i] = std::max(highs[2 * i], highs[2 * i + 1]);
+    }
+  }
+
+  void erase(size_t slot) {
+    set(slot, std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest());
+  }
+
+  // Extrema over slots [first, last], widening *low/*high in place so
+  // wrapped ring windows can be answered with two calls
+  void query(size_t first, size_t last, T *low, T *high) const {
+    size_t l = first + leaves;
+    size_t r = last + leaves + 1;
+    while (l < r) {
+      if (l & 1) {
+        *low = std::min(*low, lows[l]);
+        *high = std::max(*high, highs[l]);
+        l++;
+      }
+      if (r & 1) {
+        r--;
+        *low = std::min(*low, lows[r]);
+        *high = std::max(*high, highs[r]);
+      }
+      l >>= 1;
+      r >>= 1;
+    }
+  }
+};
+
+#endif // EXTREMA_TREE_H
@@ -0,0 +1,158 @@
+#include "fetch_task.h"
+#include "candle_snapshot.h"
+#include "log.h"
+#include "market_hours.h"
+#include "time_helper.h"
+#include "watchlist.h"
+#include <WiFi.h>
+#include <algorithm>
+
+// Static member definitions
+TaskHandle_t FetchTask::task = NULL;
+SpscQueue<candle_batch_t, 4> FetchTask::batches;
+portMUX_TYPE FetchTask::request_lock = portMUX_INITIALIZER_UNLOCKED;
+fetch_request_t FetchTask::pending = {0};
+std::atomic<bool> FetchTask::request_pending{false};
+fetch_request_t FetchTask::active = {0};
+
+bool FetchTask::begin() {
+  if (task != NULL) {
+    return true;
+  }
+
+  BaseType_t created =
+      xTaskCreatePinnedToCore(run, "fetch", FETCH_TASK_STACK, NULL,
+                              FETCH_TASK_PRIORITY, &task, FETCH_TASK_CORE);
+  if (created != pdPASS) {
+    LOG_E("Failed to start fetch task");
+    task = NULL;
+    return false;
+  }
+
+  LOG_I("Fetch task started on core %d", FETCH_TASK_CORE);
+  return true;
+}
+
+void FetchTask::requestLoad(uint32_t generation, const String &symbol,
+                            const String &interval, const String &range,
+                            int capacity, time_t resume_from) {
+  fetch_request_t request;
+  request.generation = generation;
+  strlcpy(request.symbol, symbol.c_str(), sizeof(request.symbol));
+  strlcpy(request.interval, interval.c_str(), sizeof(request.interval));
+  strlcpy(request.range, range.c_str(), sizeof(request.range));
+  request.capacity = capacity;
+  request.resume_from = resume_from;
+  strlcpy(request.base_url, DATA_BASE_URL.c_str(), sizeof(request.base_url));
+
+  portENTER_CRITICAL(&request_lock);
+  pending = request;
+  request_pending = true;
+  portEXIT_CRITICAL(&request_lock);
+}
+
+candle_batch_t *FetchTask::beginBatch(uint8_t flags) {
+  candle_batch_t *batch = waitForSlot(batches);
+  batch->generation = active.generation;
+  batch->flags = flags;
+  batch->count = 0;
+  batch->price = 0.0;
+  return batch;
+}
+
+bool FetchTask::takeRequests() {
+  if (!request_pending) {
+    return false;
+  }
+  portENTER_CRITICAL(&request_lock);
+  active = pending;
+  request_pending = false;
+  portEXIT_CRITICAL(&request_lock);
+  return true;
+}
+
+bool FetchTask::sleepUnlessRequested(uint32_t ms) {
+  unsigned long start = millis();
+  while (millis() - start < ms) {
+    if (request_pending) {
+      return true;
+    }
+    vTaskDelay(pdMS_TO_TICKS(20));
+  }
+  return false;
+}
+
+void FetchTask::run(void *arg) {
+  bool loaded = false;
+  unsigned long last_poll = 0;
+  unsigned long requested_at = 0;
+
+  for (;;) {
+    if (takeRequests()) {
+      loaded = false;
+      requested_at = millis();
+    }
+
+    // Flash writes queued by the UI core happen here, off the render path
+    CandleSnapshot::service();
+
+    if (active.generation == 0 || USE_TEST_DATA ||
+        WiFi.status() != WL_CONNECTED) {
+      sleepUnlessRequested(100);
+      continue;
+    }
+
+    if (!loaded) {
+      // After a restored snapshot, polls only need to fill the gap. That
+      // needs the clock, so give SNTP a moment before falling back.
+      if (active.resume_from > 0 && !isTimeSynchronized() &&
+          millis() - requested_at < FETCH_RESUME_WAIT_MS) {
+        sleepUnlessRequested(100);
+        continue;
+      }
+      if (active.resume_from > 0 && isTimeSynchronized() &&
+          DataFetcher::resumeFrom(active.interval, active.resume_from,
+                                  time(nullptr))) {
+        loaded = true;
+        last_poll = 0; // Poll straight away
+        continue;
+      }
+
+      loaded = DataFetcher::fetchInitialData(active.symbol, active.interval,
+                                             active.range, active.capacity);
+      if (!loaded) {
+        LOG_W("Initial load failed, retrying in %ds", FETCH_RETRY_MS / 1000);
+        sleepUnlessRequested(FETCH_RETRY_MS);
+      }
+      last_poll = millis();
+      continue;
+    }
+
+    // The watchlist keeps its own period and is not held back by the
+    // chart symbol's market hours; crypto pairs trade around the clock
+    Watchlist::pollIfDue();
+
+    // Polls ask for bars relative to now, so they wait for SNTP; the
+    // initial load above does not and runs in parallel with the sync
+    if (!isTimeSynchronized()) {
+      sleepUnlessRequested(100);
+      continue;
+    }
+
+    // Real data is never polled faster than once a second
+    unsigned long poll_interval = std::max(1000, INTRADAY_UPDATE_INTERVAL);
+    if (millis() - last_poll < poll_interval) {
+      sleepUnlessRequested(20);
+      continue;
+    }
+    last_poll = millis();
+
+    if (ENFORCE_MARKET_HOURS &&
+        !StockTracker::MarketHoursChecker::isMarketOpen()) {
+      LOG_D("Market is closed, skipping real data update");
+      continue;
+    }
+
+    DataFetcher::pollNewBars(active.symbol, active.interval, time(nullptr));
+  }
+}
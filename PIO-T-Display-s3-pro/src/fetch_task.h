@@ -0,0 +1,72 @@
+#ifndef FETCH_TASK_H
+#define FETCH_TASK_H
+
+#include "config.h"
+#include "data_fetcher.h"
+#include "spsc_queue.h"
+#include <Arduino.h>
+#include <atomic>
+
+#define FETCH_TASK_CORE 0 // Protocol core; Arduino loop() runs on core 1
+#define FETCH_TASK_STACK 12288
+#define FETCH_TASK_PRIORITY 1
+#define FETCH_RETRY_MS 5000
+#define FETCH_RESUME_WAIT_MS 5000 // How long a resume waits for SNTP
+
+typedef struct {
+  uint32_t generation;
+  char symbol[16];
+  char interval[8];
+  char range[8];
+  int capacity;       // Bars the UI store holds
+  time_t resume_from; // Newest bar restored from a snapshot, 0 if none
+  char base_url[DATA_BASE_URL_CHARS];
+} fetch_request_t;
+
+// Runs every HTTP fetch on its own task so the UI core only ever applies
+// finished candle batches. Batches flow network -> UI through a
+// single-producer/single-consumer queue. Requests flow UI -> network
+// through a one-slot mailbox: only the newest load matters, so a new
+// request overwrites one the task has not picked up yet.
+class FetchTask {
+private:
+  static TaskHandle_t task;
+  static SpscQueue<candle_batch_t, 4> batches;
+  static portMUX_TYPE request_lock;
+  static fetch_request_t pending; // Under request_lock
+  static std::atomic<bool> request_pending;
+  static fetch_request_t active;
+
+  static void run(void *arg);
+  static bool takeRequests();
+  static bool sleepUnlessRequested(uint32_t ms);
+
+public:
+  static bool begin();
+  static bool isRunning() { return task != NULL; }
+
+  // UI core
+  static void requestLoad(uint32_t generation, const String &symbol,
+                          const String &interval, const String &range,
+                          int capacity, time_t resume_from);
+  static candle_batch_t *frontBatch() { return batches.front(); }
+  static void popBatch() { batches.pop(); }
+
+  // Network core
+  // Free slot in one of the network -> UI queues. The UI drains every
+  // loop, so a full queue only ever lasts a few ms.
+  template <typename T, size_t N>
+  static T *waitForSlot(SpscQueue<T, N> &queue) {
+    T *slot;
+    while ((slot = queue.beginPush()) == NULL) {
+      vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    return slot;
+  }
+  static candle_batch_t *beginBatch(uint8_t flags);
+  static void commitBatch() { batches.commitPush(); }
+  // Every request URL starts with this; it changes with the next load
+  static const char *baseUrl() { return active.base_url; }
+};
+
+#endif // FETCH_TASK_H
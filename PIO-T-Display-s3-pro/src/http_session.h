@@ -0,0 +1,97 @@
+#ifndef HTTP_SESSION_H
+#define HTTP_SESSION_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <HTTPClient.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+
+typedef struct {
+  uint32_t requests;
+  uint32_t handshakes; // Fresh TCP (+TLS) connections opened
+  uint32_t failures;   // No response at all
+  uint32_t rejected;   // Answered with a status other than 200 (e.g. 429)
+  uint32_t last_ms;    // Request start to body drained
+  uint32_t max_ms;
+  uint64_t total_ms;
+} http_session_stats_t;
+
+// Exactly one response body read off a kept-alive connection. Undoes
+// chunked transfer encoding and stops at the end of the body, so whatever
+// follows on the socket is left for the next response.
+class HttpBody : public Client {
+private:
+  enum Mode { BODY_LENGTH, BODY_CHUNKED, BODY_UNTIL_CLOSE };
+  enum ChunkState {
+    CHUNK_SIZE,   // Hex size, then an optional extension, up to LF
+    CHUNK_DATA,   // `remaining` payload bytes
+    CHUNK_END,    // CRLF after the payload
+    CHUNK_TRAILER, // Trailer lines after the last chunk, up to a blank one
+    CHUNK_DONE
+  };
+
+  Client *src;
+  Mode mode;
+  ChunkState chunk_state;
+  int32_t remaining; // Left in the body (length mode) or current chunk
+  uint32_t chunk_size;
+  bool skip_line;    // In a chunk extension
+  uint8_t line_len;  // Trailer line length so far
+
+  void advance();
+
+public:
+  HttpBody() : src(NULL), mode(BODY_UNTIL_CLOSE), remaining(0) {}
+
+  void begin(Client *client, int content_length, bool chunked);
+  bool finished();
+  bool reusable() const { return mode != BODY_UNTIL_CLOSE; }
+  // Reads and discards the rest of the body; false if it never ended
+  bool drain(uint32_t timeout_ms);
+
+  int available() override;
+  int read() override;
+  int read(uint8_t *buf, size_t size) override;
+  int peek() override;
+  uint8_t connected() override;
+
+  // Reading only
+  int connect(IPAddress ip, uint16_t port) override { return 0; }
+  int connect(const char *host, uint16_t port) override { return 0; }
+  size_t write(uint8_t) override { return 0; }
+  size_t write(const uint8_t *buf, size_t size) override { return 0; }
+  void flush() override {}
+  void stop() override {}
+  operator bool() override { return src != NULL; }
+};
+
+// One long-lived HTTP/1.1 connection for every fetch task request. Polls to
+// the same host reuse the socket instead of paying a TCP and TLS handshake
+// each time; any error drops it and the next request reconnects. Network
+// core only, apart from getStats().
+class HttpSession {
+private:
+  static WiFiClientSecure tls;
+  static WiFiClient plain;
+  static HTTPClient http;
+  static HttpBody response;
+  static WiFiClient *client;
+  static unsigned long request_start;
+  static bool open;
+  static String origin; // Scheme, host and port the socket is connected to
+  static http_session_stats_t stats;
+
+  static int send(const String &url);
+
+public:
+  // Status code of the GET, or a negative HTTPClient error. Every call must
+  // be paired with end().
+  static int get(const String &url);
+  static HttpBody &body() { return response; }
+  // Drains the body so the connection can carry the next request
+  static void end();
+  static const http_session_stats_t &getStats() { return stats; }
+};
+
+#endif // HTTP_SESSION_H
@@ -0,0 +1,114 @@
+#include "log.h"
+#include <algorithm>
+
+// Static member definitions
+char Log::ring[LOG_RING_BYTES];
+uint32_t Log::head = 0;
+uint32_t Log::tail = 0;
+portMUX_TYPE Log::lock = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t Log::task = NULL;
+log_stats_t Log::stats = {0};
+
+bool Log::beginAsync() {
+  if (task != NULL) {
+    return true;
+  }
+  // Pinned to the UI core, where it fills the gaps between loop() passes
+  BaseType_t created = xTaskCreatePinnedToCore(
+      run, "log", LOG_TASK_STACK, NULL, LOG_TASK_PRIORITY, &task, 1);
+  if (created != pdPASS) {
+    task = NULL;
+    LOG_W("Log task not started, logging synchronously");
+    return false;
+  }
+  return true;
+}
+
+void Log::write(char level, const char *format, ...) {
+  char line[LOG_LINE_CHARS];
+  int len = snprintf(line, sizeof(line), "[%c] ", level);
+
+  va_list args;
+  va_start(args, format);
+  int body = vsnprintf(line + len, sizeof(line) - len - 2, format, args);
+  va_end(args);
+  if (body < 0) {
+    return;
+  }
+  len = std::min(len + body, (int)sizeof(line) - 3);
+
+  // Callers' own trailing newlines are folded into the line ending
+  while (len > 0 && line[len - 1] == '\n') {
+    len--;
+  }
+  line[len++] = '\r';
+  line[len++] = '\n';
+
+  if (task == NULL) {
+    stats.lines++;
+    Serial.write((const uint8_t *)line, len);
+    return;
+  }
+  enqueue(line, len);
+}
+
+void Log::enqueue(const char *line, size_t len) {
+  portENTER_CRITICAL(&lock);
+  uint32_t queued = head - tail;
+  if (queued + len > LOG_RING_BYTES) {
+    stats.dropped++;
+    portEXIT_CRITICAL(&lock);
+    return;
+  }
+  // Copy in at most two pieces around the end of the ring
+  uint32_t at = head % LOG_RING_BYTES;
+  size_t first = std::min(len, (size_t)(LOG_RING_BYTES - at));
+  memcpy(ring + at, line, first);
+  memcpy(ring, line + first, len - first);
+  head += len;
+  stats.lines++;
+  stats.high_water = std::max(stats.high_water, queued + (uint32_t)len);
+  portEXIT_CRITICAL(&lock);
+}
+
+bool Log::drain() {
+  portENTER_CRITICAL(&lock);
+  uint32_t start = tail;
+  uint32_t end = head;
+  portEXIT_CRITICAL(&lock);
+  if (start == end) {
+    return false;
+  }
+
+  // Writers only ever add past `end`, so this span is stable unlocked
+  uint32_t at = start % LOG_RING_BYTES;
+  size_t len = std::min(end - start, (uint32_t)(LOG_RING_BYTES - at));
+  Serial.write((const uint8_t *)ring + at, len);
+
+  portENTER_CRITICAL(&lock);
+  tail = start + len;
+  portEXIT_CRITICAL(&lock);
+  return true;
+}
+
+void Log::flush() {
+  // Only the task writes from the ring; give it up to a second to empty it
+  unsigned long start = millis();
+  for (;;) {
+    portENTER_CRITICAL(&lock);
+    bool empty = head == tail;
+    portEXIT_CRITICAL(&lock);
+    if (empty || task == NULL || millis() - start > 1000) {
+      return;
+    }
+    delay(1);
+  }
+}
+
+void Log::run(void *arg) {
+  for (;;) {
+    if (!drain()) {
+      vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_MS));
+    }
+  }
+}
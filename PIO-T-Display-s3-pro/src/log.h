@@ -0,0 +1,107 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_VERBOSE 5
+
+// Chosen at build time (-DLOG_LEVEL=LOG_LEVEL_DEBUG). Calls above it are
+// still type-checked, so locals kept only for a log line stay used, but sit
+// behind if (0): the arguments are never evaluated and no code is emitted.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_LINE_CHARS 192  // Longer lines are cut
+#define LOG_RING_BYTES 8192 // Lines queued for the drain task
+#define LOG_TASK_STACK 3072
+#define LOG_TASK_PRIORITY 0 // Only runs when loop() and the fetch task wait
+#define LOG_DRAIN_MS 20
+
+typedef struct {
+  uint32_t lines;
+  uint32_t dropped;    // Lines lost to a full ring
+  uint32_t high_water; // Most bytes ever queued
+} log_stats_t;
+
+// printf-style logging. Until beginAsync() each line goes straight to
+// Serial; after it, callers on either core only copy the formatted line
+// into a ring and a low-priority task does the USB writes.
+class Log {
+private:
+  static char ring[LOG_RING_BYTES];
+  static uint32_t head; // Total bytes queued, under lock
+  static uint32_t tail; // Total bytes written out, under lock
+  static portMUX_TYPE lock;
+  static TaskHandle_t task;
+  static log_stats_t stats;
+
+  static void enqueue(const char *line, size_t len);
+  static bool drain();
+  static void run(void *arg);
+
+public:
+  static bool beginAsync();
+  static void write(char level, const char *format, ...)
+      __attribute__((format(printf, 2, 3)));
+  // Waits for queued lines to reach Serial, e.g. before a restart
+  static void flush();
+  static const log_stats_t &getStats() { return stats; }
+};
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(format, ...) Log::write('E', format, ##__VA_ARGS__)
+#else
+#define LOG_E(format, ...)                                                     \
+  do {                                                                         \
+    if (0)                                                                     \
+      Log::write('E', format, ##__VA_ARGS__);                                  \
+  } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(format, ...) Log::write('W', format, ##__VA_ARGS__)
+#else
+#define LOG_W(format, ...)                                                     \
+  do {                                                                         \
+    if (0)                                                                     \
+      Log::write('W', format, ##__VA_ARGS__);                                  \
+  } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(format, ...) Log::write('I', format, ##__VA_ARGS__)
+#else
+#define LOG_I(format, ...)                                                     \
+  do {                                                                         \
+    if (0)                                                                     \
+      Log::write('I', format, ##__VA_ARGS__);                                  \
+  } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(format, ...) Log::write('D', format, ##__VA_ARGS__)
+#else
+#define LOG_D(format, ...)                                                     \
+  do {                                                                         \
+    if (0)                                                                     \
+      Log::write('D', format, ##__VA_ARGS__);                                  \
+  } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+#define LOG_V(format, ...) Log::write('V', format, ##__VA_ARGS__)
+#else
+#define LOG_V(format, ...)                                                     \
+  do {                                                                         \
+    if (0)                                                                     \
+      Log::write('V', format, ##__VA_ARGS__);                                  \
+  } while (0)
+#endif
+
+#endif // LOG_H
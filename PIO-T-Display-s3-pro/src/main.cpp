@@ -1,15 +1,23 @@
+#include "candle_snapshot.h"
 #include "config.h"
 #include "credentials.h"
 #include "data_fetcher.h"
 #include "enhanced_candle_stick.h"
+#include "event_stream.h"
+#include "fetch_task.h"
+#include "http_session.h"
+#include "log.h"
 #include "market_hours.h"
+#include "metrics.h"
 #include "time_helper.h"
 #include "ui.h"
+#include "watchlist.h"
 #include "web_server.h"
 #include <Arduino.h>
 #include <LV_Helper.h>
 #include <LilyGo_AMOLED.h>
 #include <WiFi.h>
+#include <algorithm>
 #include <lvgl.h>
 
 LilyGo_Class amoled;
@@ -21,6 +29,21 @@ static String last_interval = "";
 static String last_range = "";
 static int last_bars_to_show = 0;
 
+#define WIFI_CONNECT_TIMEOUT_MS 20000
+
+// Set from the WiFi event task, consumed by advanceBoot() in loop()
+static volatile bool wifi_has_ip = false;
+static bool network_up = false;  // Web server running for the current link
+static bool data_started = false;
+
+// Boot timeline in ms since reset, 0 until reached
+static struct {
+  unsigned long display;
+  unsigned long ip;
+  unsigned long time;
+  unsigned long first_bar;
+} boot = {0};
+
 // Helper function to parse IP string to IPAddress
 IPAddress parseIPAddress(const String &ipStr) {
   IPAddress ip;
@@ -31,12 +54,28 @@ IPAddress parseIPAddress(const String &ipStr) {
   return IPAddress(192, 168, 4, 184);
 }
 
-void connectWiFi() {
-  Serial.println("Connecting to WiFi...");
+void onWiFiEvent(WiFiEvent_t event) {
+  switch (event) {
+  case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+    wifi_has_ip = true;
+    break;
+  case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+  case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+    wifi_has_ip = false;
+    break;
+  default:
+    break;
+  }
+}
+
+// Starts the association and returns at once; the stack reconnects on its
+// own and onWiFiEvent reports progress
+void startWiFi() {
+  LOG_I("Connecting to WiFi...");
 
   // Use configuration variables instead of hardcoded values
   if (USE_STATIC_IP) {
-    Serial.println("Configuring static IP...");
+    LOG_D("Configuring static IP...");
 
     IPAddress local_IP = parseIPAddress(STATIC_IP);
     IPAddress gateway = parseIPAddress(GATEWAY_IP);
@@ -44,49 +83,137 @@ void connectWiFi() {
     IPAddress primaryDNS(8, 8, 8, 8);   // Google DNS
     IPAddress secondaryDNS(8, 8, 4, 4); // Google DNS secondary
 
-    Serial.println("Static IP: " + STATIC_IP);
-    Serial.println("Gateway: " + GATEWAY_IP);
-    Serial.println("Subnet: " + SUBNET_MASK);
+    LOG_I("Static IP: %s, gateway: %s, subnet: %s", STATIC_IP.c_str(),
+          GATEWAY_IP.c_str(), SUBNET_MASK.c_str());
 
     // Configure static IP
     if (!WiFi.config(local_IP, gateway, subnet, primaryDNS, secondaryDNS)) {
-      Serial.println("Static IP configuration failed");
+      LOG_E("Static IP configuration failed");
     } else {
-      Serial.println("Static IP configuration successful");
+      LOG_D("Static IP configuration successful");
     }
   } else {
-    Serial.println("Using DHCP...");
+    LOG_I("Using DHCP...");
   }
 
+  WiFi.onEvent(onWiFiEvent);
+  WiFi.setAutoReconnect(true);
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+}
 
-  unsigned long startAttemptTime = millis();
-  while (WiFi.status() != WL_CONNECTED && millis() - startAttemptTime < 20000) {
-    delay(500);
-    Serial.print(".");
+void showStatusLabel(const char *text, lv_color_t color) {
+  // One label, reused until the chart clears its container
+  static lv_obj_t *label = NULL;
+  lv_obj_t *chart_container = (lv_obj_t *)lv_obj_get_user_data(ui_chart);
+  if (chart_container == NULL) {
+    return;
+  }
+  if (label == NULL || !lv_obj_is_valid(label)) {
+    label = lv_label_create(chart_container);
   }
-  Serial.println();
-
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("WiFi connected successfully");
-    Serial.print("IP address: ");
-    Serial.println(WiFi.localIP());
-    Serial.print("Gateway: ");
-    Serial.println(WiFi.gatewayIP());
-    Serial.print("Subnet: ");
-    Serial.println(WiFi.subnetMask());
-    Serial.print("DNS 1: ");
-    Serial.println(WiFi.dnsIP(0));
-    Serial.print("DNS 2: ");
-    Serial.println(WiFi.dnsIP(1));
+  lv_label_set_text(label, text);
+  lv_obj_center(label);
+  lv_obj_set_style_text_color(label, color, 0);
+}
+
+void startData() {
+  data_started = true;
+
+  // Real data arrives from the fetch task and the chart is created in
+  // loop() once the first batch is applied
+  LOG_D("Initializing data fetcher...");
+  if (DataFetcher::initialize(STOCK_SYMBOL)) {
+    LOG_D("Data fetcher initialized successfully");
+
+    if (DataFetcher::getCandleCount() > 0) {
+      LOG_I("Data loaded, creating chart with %d candles",
+            DataFetcher::getCandleCount());
+      EnhancedCandleStick::create(ui_chart, STOCK_SYMBOL);
+    }
   } else {
-    Serial.println("WiFi connection failed");
+    LOG_E("Failed to initialize data fetcher");
+    data_needs_refresh = true;
+  }
+
+  Watchlist::configure(WATCHLIST);
+}
+
+// Brings services up and down as the link comes and goes. Nothing here
+// waits: the chart load runs on the fetch task while SNTP syncs.
+void advanceBoot() {
+  if (wifi_has_ip && !network_up) {
+    network_up = true;
+
+    if (boot.ip == 0) {
+      boot.ip = millis();
+      LOG_I("Boot: IP %s after %lu ms", WiFi.localIP().toString().c_str(),
+            boot.ip);
+      LOG_I("Gateway: %s, DNS: %s / %s",
+            WiFi.gatewayIP().toString().c_str(),
+            WiFi.dnsIP(0).toString().c_str(),
+            WiFi.dnsIP(1).toString().c_str());
+      initiateNTPTimeSync();
+    } else {
+      LOG_I("WiFi reconnected");
+    }
+
+    if (StockWebServer::begin()) {
+      LOG_I("Web server started");
+    } else {
+      LOG_E("Failed to start web server");
+    }
+
+    if (!data_started) {
+      startData();
+    }
+    if (DataFetcher::getCandleCount() == 0) {
+      showStatusLabel("Loading stock data...", lv_color_white());
+    }
+  } else if (!wifi_has_ip && network_up) {
+    network_up = false;
+    LOG_W("WiFi disconnected, waiting for the stack to reconnect");
+    StockWebServer::stop();
+  }
+
+  static unsigned long wifi_wait_start = boot.display;
+  if (boot.ip == 0 && DataFetcher::getCandleCount() == 0 &&
+      millis() - wifi_wait_start > WIFI_CONNECT_TIMEOUT_MS) {
+    // Keep trying in the background; the chart starts once the link is up
+    LOG_W("WiFi connection failed, still retrying");
+    showStatusLabel("WiFi Connection Failed", lv_color_make(255, 0, 0));
+    wifi_wait_start = millis();
+  }
+
+  if (boot.time == 0 && isTimeSynchronized()) {
+    boot.time = millis();
+    LOG_I("Boot: time synced after %lu ms", boot.time);
   }
 }
 
 void checkConfigChanges() {
   // Track the previous test data state
   static bool last_use_test_data = USE_TEST_DATA;
+  static bool last_canvas_renderer = USE_CANVAS_RENDERER;
+  static int last_history_bars = HISTORY_BARS;
+  static String last_watchlist = WATCHLIST;
+  static String last_base_url = DATA_BASE_URL;
+
+  // The watchlist is polled separately and never needs a chart rebuild
+  if (last_watchlist != WATCHLIST) {
+    LOG_I("Watchlist: %s -> %s", last_watchlist.c_str(), WATCHLIST.c_str());
+    Watchlist::configure(WATCHLIST);
+    last_watchlist = WATCHLIST;
+  }
+
+  // Same chart, different server: only the data is reloaded
+  if (last_base_url != DATA_BASE_URL) {
+    LOG_I("Data source: %s -> %s", last_base_url.c_str(),
+          DATA_BASE_URL.c_str());
+    if (!USE_TEST_DATA) {
+      data_needs_refresh = true;
+    }
+    last_base_url = DATA_BASE_URL;
+  }
 
   // Check if any critical parameters have changed
   bool config_changed = false;
@@ -94,28 +221,42 @@ void checkConfigChanges() {
 
   if (last_symbol != STOCK_SYMBOL || last_interval != YAHOO_INTERVAL ||
       last_range != YAHOO_RANGE || last_bars_to_show != BARS_TO_SHOW ||
-      last_use_test_data != USE_TEST_DATA) {
+      last_use_test_data != USE_TEST_DATA ||
+      last_canvas_renderer != USE_CANVAS_RENDERER ||
+      last_history_bars != HISTORY_BARS) {
 
     config_changed = true;
 
-    Serial.println("Configuration changed, refreshing display...");
-    Serial.println("Symbol: " + last_symbol + " -> " + STOCK_SYMBOL);
-    Serial.println("Interval: " + last_interval + " -> " + YAHOO_INTERVAL);
-    Serial.println("Range: " + last_range + " -> " + YAHOO_RANGE);
-    Serial.println("Bars: " + String(last_bars_to_show) + " -> " +
-                   String(BARS_TO_SHOW));
-    Serial.println("Use Test Data: " + String(last_use_test_data) + " -> " +
-                   String(USE_TEST_DATA));
+    LOG_I("Configuration changed, refreshing display...");
+    LOG_I("Symbol: %s -> %s, interval: %s -> %s, range: %s -> %s",
+          last_symbol.c_str(), STOCK_SYMBOL.c_str(), last_interval.c_str(),
+          YAHOO_INTERVAL.c_str(), last_range.c_str(), YAHOO_RANGE.c_str());
+    LOG_I("Bars: %d -> %d, test data: %d -> %d, canvas: %d -> %d, "
+          "history: %d -> %d",
+          last_bars_to_show, BARS_TO_SHOW, last_use_test_data, USE_TEST_DATA,
+          last_canvas_renderer, USE_CANVAS_RENDERER, last_history_bars,
+          HISTORY_BARS);
 
     // Check if data source changed (real data <-> test data)
     if (last_use_test_data != USE_TEST_DATA) {
       data_source_changed = true;
-      Serial.println("Data source changed - will reset data fetcher");
+      LOG_D("Data source changed - will reset data fetcher");
     }
 
-    // Refresh data if symbol, interval, range, or data source changed
-    if (last_symbol != STOCK_SYMBOL || last_interval != YAHOO_INTERVAL ||
-        last_range != YAHOO_RANGE || data_source_changed) {
+    // An interval change alone is usually folded from the bars we hold
+    bool interval_only = last_interval != YAHOO_INTERVAL &&
+                         last_symbol == STOCK_SYMBOL &&
+                         last_range == YAHOO_RANGE &&
+                         last_history_bars == HISTORY_BARS &&
+                         !data_source_changed;
+
+    // Refresh data if symbol, interval, range, history size, or data
+    // source changed; a new history size reallocates the store
+    if (interval_only && DataFetcher::switchInterval(YAHOO_INTERVAL)) {
+      LOG_I("Interval switched locally, no refetch needed");
+    } else if (last_symbol != STOCK_SYMBOL ||
+               last_interval != YAHOO_INTERVAL || last_range != YAHOO_RANGE ||
+               last_history_bars != HISTORY_BARS || data_source_changed) {
       data_needs_refresh = true;
     }
 
@@ -125,6 +266,8 @@ void checkConfigChanges() {
     last_range = YAHOO_RANGE;
     last_bars_to_show = BARS_TO_SHOW;
     last_use_test_data = USE_TEST_DATA;
+    last_canvas_renderer = USE_CANVAS_RENDERER;
+    last_history_bars = HISTORY_BARS;
 
     // Always refresh chart display for any config change
     EnhancedCandleStick::create(ui_chart, STOCK_SYMBOL);
@@ -133,30 +276,29 @@ void checkConfigChanges() {
 
 void refreshDataIfNeeded() {
   if (data_needs_refresh) {
-    Serial.println("Reinitializing data fetcher with new parameters...");
+    LOG_I("Reinitializing data fetcher with new parameters...");
 
-    // First, reset the data fetcher to clear any existing data
+    // Keep what we have for next time, then clear it
+    DataFetcher::saveSnapshot();
     DataFetcher::reset();
-    Serial.println("Data fetcher reset - all existing data cleared");
+    LOG_D("Data fetcher reset - all existing data cleared");
 
     // Initialize data fetcher with new settings
     if (DataFetcher::initialize(STOCK_SYMBOL)) {
-      Serial.println("Data fetcher reinitialized successfully");
+      LOG_D("Data fetcher reinitialized successfully");
 
-      // Wait a moment for data to be processed
-      delay(500);
-
-      // Verify we have data
+      // Test data and snapshots are ready now; fetched data is redrawn
+      // when it arrives
       if (DataFetcher::getCandleCount() > 0) {
-        Serial.println("New data loaded successfully, creating chart with " +
-                       String(DataFetcher::getCandleCount()) + " candles");
+        LOG_I("New data loaded, creating chart with %d candles",
+              DataFetcher::getCandleCount());
         // Force immediate chart update
         EnhancedCandleStick::create(ui_chart, STOCK_SYMBOL);
       } else {
-        Serial.println("Warning: No data loaded after reinitialization");
+        LOG_D("Waiting for fetch task to deliver data");
       }
     } else {
-      Serial.println("Failed to reinitialize data fetcher");
+      LOG_E("Failed to reinitialize data fetcher");
     }
 
     data_needs_refresh = false;
@@ -165,13 +307,15 @@ void refreshDataIfNeeded() {
 
 void setup() {
   Serial.begin(115200);
-  delay(1000);
+  // From here on log lines are written out by a task of their own
+  Log::beginAsync();
+  Metrics::begin();
 
-  Serial.println("Starting Stock Tracker...");
+  LOG_I("Starting Stock Tracker...");
 
   // Initialize display
   if (!amoled.begin()) {
-    Serial.println("Display initialization failed!");
+    LOG_E("Display initialization failed!");
     while (1)
       delay(1000);
   }
@@ -192,7 +336,7 @@ void setup() {
   if (!USE_INTRADAY_DATA) {
     USE_INTRADAY_DATA = true;
     saveConfig();
-    Serial.println("Intraday data enabled for real-time updates");
+    LOG_I("Intraday data enabled for real-time updates");
   }
 
   // Store initial configuration state
@@ -201,81 +345,93 @@ void setup() {
   last_range = YAHOO_RANGE;
   last_bars_to_show = BARS_TO_SHOW;
 
-  // Connect to WiFi using configuration
-  connectWiFi();
+  // Network fetches run on their own core from here on
+  FetchTask::begin();
 
   // Load chart screen first
   lv_scr_load(ui_chart);
+  boot.display = millis();
+  LOG_I("Boot: display up after %lu ms", boot.display);
 
-  if (WiFi.status() == WL_CONNECTED) {
-    // Start web server
-    if (StockWebServer::begin()) {
-      Serial.println("Web server started successfully");
-    } else {
-      Serial.println("Failed to start web server");
-    }
+  // Test data and a saved snapshot need no network, so they render right
+  // away; live loads queue until the link is up
+  CandleSnapshot::begin();
+  startData();
 
-    // Start NTP sync
-    initiateNTPTimeSync();
+  // Association, DHCP and SNTP complete in the background; advanceBoot()
+  // starts the web server and the chart load once an IP arrives
+  startWiFi();
+}
 
-    // Show loading message initially
-    lv_obj_t *chart_container = (lv_obj_t *)lv_obj_get_user_data(ui_chart);
-    if (chart_container != NULL) {
-      lv_obj_t *loading_label = lv_label_create(chart_container);
-      lv_label_set_text(loading_label, "Loading stock data...");
-      lv_obj_center(loading_label);
-      lv_obj_set_style_text_color(loading_label, lv_color_white(), 0);
+void loop() {
+  // Track the worst gap between UI frames so render stalls show in the log
+  static unsigned long lastFrame = 0;
+  static unsigned long worstFrameGap = 0;
+  static unsigned long lastFrameReport = 0;
+  unsigned long frameStart = millis();
+  if (lastFrame != 0) {
+    worstFrameGap = std::max(worstFrameGap, frameStart - lastFrame);
+  }
+  lastFrame = frameStart;
+  if (frameStart - lastFrameReport > 10000) {
+    const lv_helper_flush_stats_t &flush = lvglHelperFlushStats();
+    LOG_I("UI worst frame gap: %lu ms, last flush: %u bytes in %u rects, "
+          "max %u bytes",
+          worstFrameGap, flush.last_frame_bytes, flush.last_frame_rects,
+          flush.max_frame_bytes);
+    if (flush.async && flush.wire_us > 0) {
+      // Bus time LVGL did not have to wait for was spent rendering instead
+      uint64_t hidden_us =
+          flush.wire_us > flush.wait_us ? flush.wire_us - flush.wait_us : 0;
+      LOG_I("DMA flush: %llu ms on the bus, %llu ms overlapped (%u%%), "
+            "%llu ms in flush_cb",
+            flush.wire_us / 1000, hidden_us / 1000,
+            (unsigned)(hidden_us * 100 / flush.wire_us),
+            flush.flush_us / 1000);
     }
-
-    // Initialize data fetcher and wait for data to load
-    Serial.println("Initializing data fetcher...");
-    if (DataFetcher::initialize(STOCK_SYMBOL)) {
-      Serial.println("Data fetcher initialized successfully");
-
-      // Wait a moment for data to be processed, then create chart
-      delay(1000);
-
-      // Verify we have data before creating chart
-      int attempts = 0;
-      while (DataFetcher::getCandleCount() == 0 && attempts < 10) {
-        Serial.println("Waiting for data to load... attempt " +
-                       String(attempts + 1));
-        delay(1000);
-        attempts++;
-      }
-
-      if (DataFetcher::getCandleCount() > 0) {
-        Serial.println("Data loaded successfully, creating chart with " +
-                       String(DataFetcher::getCandleCount()) + " candles");
-        EnhancedCandleStick::create(ui_chart, STOCK_SYMBOL);
-      } else {
-        Serial.println("No data loaded after retries, will retry in main loop");
-        // Mark that we need to refresh data
-        data_needs_refresh = true;
-      }
-    } else {
-      Serial.println("Failed to initialize data fetcher");
-      data_needs_refresh = true;
+    // Written by the fetch task; a torn read only skews one report
+    const http_session_stats_t &net = HttpSession::getStats();
+    if (net.requests > 0) {
+      LOG_I("HTTP: %u requests over %u handshakes, %u failed, %u rejected, "
+            "last %u ms, avg %u ms, max %u ms",
+            net.requests, net.handshakes, net.failures, net.rejected,
+            net.last_ms, (unsigned)(net.total_ms / net.requests), net.max_ms);
     }
-  } else {
-    Serial.println("Cannot proceed without WiFi connection");
-    // Show error screen or message
-    lv_obj_t *chart_container = (lv_obj_t *)lv_obj_get_user_data(ui_chart);
-    if (chart_container != NULL) {
-      lv_obj_t *error_label = lv_label_create(chart_container);
-      lv_label_set_text(error_label, "WiFi Connection Failed");
-      lv_obj_center(error_label);
-      lv_obj_set_style_text_color(error_label, lv_color_make(255, 0, 0), 0);
+    const event_stream_stats_t &events = EventStream::getStats();
+    if (events.clients_served > 0) {
+      LOG_I("Events: %d clients, %u published, %u dropped",
+            EventStream::clientCount(), events.published, events.dropped);
     }
+    const config_save_stats_t &saves = getConfigSaveStats();
+    if (saves.saves > 0) {
+      LOG_I("Config: %u NVS commits, %u keys written, %u failed, "
+            "last %u us, max %u us",
+            saves.saves, saves.keys_written, saves.failures, saves.last_us,
+            saves.max_us);
+    }
+    const log_stats_t &logs = Log::getStats();
+    if (logs.dropped > 0) {
+      LOG_W("Log: %u lines, %u dropped, high water %u of %u bytes",
+            logs.lines, logs.dropped, logs.high_water, LOG_RING_BYTES);
+    }
+    worstFrameGap = 0;
+    lastFrameReport = frameStart;
   }
-}
 
-void loop() {
+  // Only passes that drew something are timed; the rest are near free
+  uint32_t frames = lvglHelperFlushStats().frames;
+  uint32_t lvgl_start = Metrics::cycles();
   lv_task_handler();
+  const lv_helper_flush_stats_t &drawn = lvglHelperFlushStats();
+  if (drawn.frames != frames) {
+    Metrics::recordSince(METRIC_LVGL_FRAME, lvgl_start);
+    Metrics::record(METRIC_FLUSH, drawn.last_frame_us);
+  }
   delay(5);
 
   // Handle web server requests
   StockWebServer::handleClient();
+  serviceConfigSave();
 
   // Check for configuration changes
   static unsigned long lastConfigCheck = 0;
@@ -285,24 +441,20 @@ void loop() {
     lastConfigCheck = millis();
   }
 
-  // ADDED: Initial data retry mechanism
+  // Create the chart as soon as the first data is available. The fetch
+  // task retries failed loads on its own.
   static bool initial_chart_created = false;
-  static unsigned long lastInitialRetry = 0;
 
-  if (!initial_chart_created && WiFi.status() == WL_CONNECTED) {
-    if (DataFetcher::getCandleCount() > 0) {
-      Serial.println("Initial chart creation - data now available");
-      EnhancedCandleStick::create(ui_chart, STOCK_SYMBOL);
-      initial_chart_created = true;
-    } else if (millis() - lastInitialRetry > 5000) { // Retry every 5 seconds
-      Serial.println("Retrying initial data load...");
-      if (DataFetcher::initialize(STOCK_SYMBOL)) {
-        if (DataFetcher::getCandleCount() > 0) {
-          EnhancedCandleStick::create(ui_chart, STOCK_SYMBOL);
-          initial_chart_created = true;
-        }
-      }
-      lastInitialRetry = millis();
+  if (!initial_chart_created && DataFetcher::getCandleCount() > 0) {
+    LOG_D("Initial chart creation - data now available");
+    EnhancedCandleStick::create(ui_chart, STOCK_SYMBOL);
+    initial_chart_created = true;
+
+    if (boot.first_bar == 0) {
+      boot.first_bar = millis();
+      LOG_I("Boot timeline: display %lu ms, IP %lu ms, time %lu ms, "
+            "first bar %lu ms",
+            boot.display, boot.ip, boot.time, boot.first_bar);
     }
   }
 
@@ -313,44 +465,22 @@ void loop() {
     lastTimeUpdate = millis();
   }
 
-  // MODIFIED: Update stock data using millisecond intervals
-  static unsigned long lastStockUpdate = 0;
-  unsigned long updateInterval =
-      INTRADAY_UPDATE_INTERVAL; // Now in milliseconds
-
-  // Enforce minimum intervals based on data type
-  if (!USE_TEST_DATA && updateInterval < 1000) {
-    updateInterval = 1000; // Force minimum 1 second for real data
+  // Apply finished fetches (or the next test tick). Never blocks on the
+  // network; update pacing lives in DataFetcher and FetchTask.
+  uint32_t merge_start = Metrics::cycles();
+  bool updated = DataFetcher::updateData();
+  if (updated) {
+    Metrics::recordSince(METRIC_CANDLE_MERGE, merge_start);
   }
-
-  if (millis() - lastStockUpdate > updateInterval) {
-    if (WiFi.status() == WL_CONNECTED && initial_chart_created) {
-      if (DataFetcher::updateData()) {
-        // Only update chart if new data was fetched
-        EnhancedCandleStick::update(ui_chart, STOCK_SYMBOL);
-      }
-    }
-    lastStockUpdate = millis();
+  if (updated && initial_chart_created) {
+    // Only update chart if new data arrived
+    EnhancedCandleStick::update(ui_chart, STOCK_SYMBOL);
+    EventStream::publish(STOCK_SYMBOL, DataFetcher::getCandle(0),
+                         DataFetcher::getCurrentPrice());
   }
 
-  // Check WiFi connection and reconnect if needed
-  static unsigned long lastWiFiCheck = 0;
-  if (millis() - lastWiFiCheck > 30000) { // Check every 30 seconds
-    if (WiFi.status() != WL_CONNECTED) {
-      Serial.println("WiFi disconnected, attempting to reconnect...");
-      StockWebServer::stop(); // Stop web server during reconnection
-      connectWiFi();
-
-      // Restart web server if WiFi reconnected
-      if (WiFi.status() == WL_CONNECTED) {
-        StockWebServer::begin();
-      }
-
-      // Reset initial chart flag to retry creation
-      initial_chart_created = false;
-    }
-    lastWiFiCheck = millis();
-  }
+  // Follow WiFi and SNTP events without blocking the frame
+  advanceBoot();
 
   // Periodic chart refresh (every 5 minutes) to ensure UI stays updated
   static unsigned long lastChartRefresh = 0;
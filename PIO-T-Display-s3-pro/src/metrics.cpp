@@ -0,0 +1,29 @@
+#include "metrics.h"
+#include <algorithm>
+
+// Static member definitions
+const uint32_t Metrics::bucket_us[METRIC_BUCKET_COUNT] = {
+    50,    100,    250,    500,    1000,   2500,    5000,
+    10000, 25000,  50000,  100000, 250000, 1000000, 5000000};
+const char *const Metrics::stage_names[METRIC_STAGE_COUNT] = {
+    "http_connect",  "http_response", "body_read",
+    "json_parse",    "candle_merge",  "chart_rebuild",
+    "chart_update",  "lvgl_frame",    "flush"};
+metric_histogram_t Metrics::histograms[METRIC_STAGE_COUNT] = {};
+uint32_t Metrics::cycles_per_us = 240;
+
+void Metrics::begin() {
+  cycles_per_us = std::max<uint32_t>(1, getCpuFrequencyMhz());
+}
+
+void Metrics::record(MetricStage stage, uint32_t us) {
+  int bucket = 0;
+  while (bucket < METRIC_BUCKET_COUNT && us > bucket_us[bucket]) {
+    bucket++;
+  }
+
+  metric_histogram_t &h = histograms[stage];
+  h.buckets[bucket]++;
+  h.sum_us += us;
+  h.max_us = std::max(h.max_us, us);
+}
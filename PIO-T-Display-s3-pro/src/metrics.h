@@ -0,0 +1,64 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+
+// Stages of the update pipeline, each with its own latency histogram
+enum MetricStage {
+  METRIC_HTTP_CONNECT = 0, // TCP and TLS handshake for a fresh socket
+  METRIC_HTTP_RESPONSE,    // Request sent until status and headers are read
+  METRIC_BODY_READ,        // Waiting on and copying body bytes
+  METRIC_JSON_PARSE,       // Tokenizing body bytes into candle columns
+  METRIC_CANDLE_MERGE,     // Fetched batches or a test tick into the store
+  METRIC_CHART_REBUILD,    // EnhancedCandleStick::create
+  METRIC_CHART_UPDATE,     // EnhancedCandleStick::update, rebuilds included
+  METRIC_LVGL_FRAME,       // lv_task_handler() passes that drew a frame
+  METRIC_FLUSH,            // Flush callbacks for one frame
+  METRIC_STAGE_COUNT
+};
+
+#define METRIC_BUCKET_COUNT 14 // Upper bounds, plus an overflow bucket
+
+typedef struct {
+  uint32_t buckets[METRIC_BUCKET_COUNT + 1]; // Not cumulative; last is +Inf
+  uint64_t sum_us;
+  uint32_t max_us;
+} metric_histogram_t;
+
+// Fixed-bucket histograms of stage times. A stage is only ever recorded by
+// one task (the fetch task for HTTP and parsing, loop() for the rest), so
+// recording takes no lock; a reader on the other core can see one sample
+// half applied.
+class Metrics {
+private:
+  static const uint32_t bucket_us[METRIC_BUCKET_COUNT];
+  static const char *const stage_names[METRIC_STAGE_COUNT];
+  static metric_histogram_t histograms[METRIC_STAGE_COUNT];
+  static uint32_t cycles_per_us;
+
+public:
+  static void begin();
+
+  // Cycle counter of the calling core. It wraps after about 17 s at
+  // 240 MHz, so a start and its end must be read on the same core.
+  static uint32_t cycles() { return ESP.getCycleCount(); }
+  static uint32_t cyclesToUs(uint32_t cycles) {
+    return cycles / cycles_per_us;
+  }
+
+  static void record(MetricStage stage, uint32_t us);
+  // Records the time since `start`, a cycles() reading
+  static void recordSince(MetricStage stage, uint32_t start) {
+    record(stage, cyclesToUs(cycles() - start));
+  }
+
+  static const metric_histogram_t &getHistogram(MetricStage stage) {
+    return histograms[stage];
+  }
+  static const char *stageName(MetricStage stage) {
+    return stage_names[stage];
+  }
+  static uint32_t bucketBound(int bucket) { return bucket_us[bucket]; }
+};
+
+#endif // METRICS_H
@@ -0,0 +1,75 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lock-free single-producer / single-consumer ring. Slots are filled and
+// drained in place so large items are never copied through the stack.
+template <typename T, size_t N> class SpscQueue {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+
+private:
+  T slots[N];
+  std::atomic<uint32_t> head{0}; // Next slot the producer writes
+  std::atomic<uint32_t> tail{0}; // Next slot the consumer reads
+
+public:
+  // Producer: free slot to fill, or NULL when the queue is full
+  T *beginPush() {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == N) {
+      return NULL;
+    }
+    return &slots[h & (N - 1)];
+  }
+
+  // Producer: publish the slot returned by beginPush()
+  void commitPush() {
+    head.store(head.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+  }
+
+  bool push(const T &item) {
+    T *slot = beginPush();
+    if (slot == NULL) {
+      return false;
+    }
+    *slot = item;
+    commitPush();
+    return true;
+  }
+
+  // Consumer: oldest published slot, or NULL when empty
+  T *front() {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) == t) {
+      return NULL;
+    }
+    return &slots[t & (N - 1)];
+  }
+
+  // Consumer: hand the slot returned by front() back to the producer
+  void pop() {
+    tail.store(tail.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+  }
+
+  bool pop(T &item) {
+    T *slot = front();
+    if (slot == NULL) {
+      return false;
+    }
+    item = *slot;
+    pop();
+    return true;
+  }
+
+  size_t size() const {
+    return head.load(std::memory_order_acquire) -
+           tail.load(std::memory_order_acquire);
+  }
+};
+
+#endif // SPSC_QUEUE_H
@@ -1,10 +1,13 @@
 #include "time_helper.h"
 #include "config.h"
+#include "log.h"
 #include "ui.h"
 #include <Arduino.h>
+#include <esp_sntp.h>
 #include <time.h>
 
-static bool ntpSyncCompleted = false;
+// Set from the SNTP task once the first server reply is applied
+static volatile bool ntpSyncCompleted = false;
 
 #define INFO_PANEL_ID 0x1001
 #define SYMBOL_LABEL_ID 0x1002
@@ -14,34 +17,17 @@ static bool ntpSyncCompleted = false;
 #define TIME_LABEL_ID 0x1006
 #define DATE_LABEL_ID 0x1007
 
+static void onTimeSynced(struct timeval *tv) {
+    ntpSyncCompleted = true;
+}
+
 void initiateNTPTimeSync() {
+    // SNTP keeps retrying on its own; completion arrives via the callback
+    sntp_set_time_sync_notification_cb(onTimeSynced);
     configTime(0, 0, "pool.ntp.org", "time.nist.gov");
     setenv("TZ", TIME_ZONE, 1);
     tzset();
-    
-    // Wait for time to be set
-    time_t now = time(nullptr);
-    int retries = 0;
-    while (now < 8 * 3600 * 2 && retries < 20) { // Increased retries for more reliability
-        delay(500);
-        Serial.println("Waiting for NTP time sync...");
-        now = time(nullptr);
-        retries++;
-    }
-    
-    if (now > 8 * 3600 * 2) {
-        ntpSyncCompleted = true;
-        Serial.println("NTP time sync completed successfully");
-        
-        // Print current time to verify
-        struct tm timeinfo;
-        localtime_r(&now, &timeinfo);
-        char timeStr[30];
-        strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S %Z", &timeinfo);
-        Serial.printf("Current time: %s\n", timeStr);
-    } else {
-        Serial.println("NTP time sync failed after retries");
-    }
+    LOG_I("NTP time sync started");
 }
 
 bool isTimeSynchronized() {
@@ -69,15 +55,21 @@ static lv_obj_t* find_obj_by_id(lv_obj_t *parent, uint32_t id) {
 
 void updateTimeAndDate() {
     if (!ntpSyncCompleted) {
-        // Try to sync if not already synchronized
-        static unsigned long lastSyncAttempt = 0;
-        if (millis() - lastSyncAttempt > 60000) { // Try every minute
-            initiateNTPTimeSync();
-            lastSyncAttempt = millis();
-        }
         return;
     }
 
+    static bool syncLogged = false;
+    if (!syncLogged) {
+        // Print current time to verify
+        time_t now = time(nullptr);
+        struct tm timeinfo;
+        localtime_r(&now, &timeinfo);
+        char timeStr[30];
+        strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S %Z", &timeinfo);
+        LOG_I("NTP time sync completed: %s", timeStr);
+        syncLogged = true;
+    }
+
     // Only update time strings every second
     static unsigned long lastTimeStringUpdate = 0;
     static char timeStr[9] = "00:00:00";
@@ -97,7 +89,7 @@ void updateTimeAndDate() {
         // Debug output for date format verification (remove after testing)
         static unsigned long lastDebugOutput = 0;
         if (millis() - lastDebugOutput > 30000) { // Debug every 30 seconds
-            Serial.printf("Date display format: %s (MM-DD-YY)\n", dateStr);
+            LOG_V("Date display format: %s (MM-DD-YY)", dateStr);
             lastDebugOutput = millis();
         }
     }
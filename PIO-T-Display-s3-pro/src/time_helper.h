@@ -2,7 +2,7 @@
 #define TIME_HELPER_H
 
 // Function declarations for time syncing and updating the UI
-void initiateNTPTimeSync(); // Initiates non-blocking NTP sync
+void initiateNTPTimeSync(); // Starts SNTP and returns immediately
 bool isTimeSynchronized();  // Returns true if NTP time is synced
 void updateTimeAndDate();   // Updates the UI with current time and date
 
@@ -0,0 +1,259 @@
+#include "watchlist.h"
+#include "fetch_task.h"
+#include "http_session.h"
+#include "log.h"
+#include <ArduinoJson.h>
+#include <algorithm>
+
+// Static member definitions
+char Watchlist::symbols[WATCHLIST_MAX_SYMBOLS][16];
+int Watchlist::symbol_count = 0;
+CandleStore Watchlist::stores[WATCHLIST_MAX_SYMBOLS];
+float Watchlist::prices[WATCHLIST_MAX_SYMBOLS];
+float Watchlist::previous_closes[WATCHLIST_MAX_SYMBOLS];
+uint32_t Watchlist::generation = 0;
+portMUX_TYPE Watchlist::request_lock = portMUX_INITIALIZER_UNLOCKED;
+watch_request_t Watchlist::pending = {0};
+std::atomic<bool> Watchlist::request_pending{false};
+SpscQueue<quote_batch_t, 2> Watchlist::batches;
+watch_request_t Watchlist::active = {0};
+char Watchlist::active_symbols[WATCHLIST_MAX_SYMBOLS][16];
+int Watchlist::active_count = 0;
+time_t Watchlist::sent_newest[WATCHLIST_MAX_SYMBOLS];
+unsigned long Watchlist::last_poll = 0;
+
+int Watchlist::split(const char *list, char out[][16]) {
+  int n = 0;
+  const char *start = list;
+  while (*start != '\0' && n < WATCHLIST_MAX_SYMBOLS) {
+    const char *end = strchr(start, ',');
+    size_t len = (end != NULL) ? (size_t)(end - start) : strlen(start);
+    if (len > 0 && len < sizeof(out[n])) {
+      memcpy(out[n], start, len);
+      out[n][len] = '\0';
+      n++;
+    }
+    if (end == NULL) {
+      break;
+    }
+    start = end + 1;
+  }
+  return n;
+}
+
+void Watchlist::configure(const String &list) {
+  // Points still queued for the previous list are dropped by generation
+  generation++;
+  symbol_count = split(list.c_str(), symbols);
+
+  for (int i = 0; i < symbol_count; i++) {
+    if (stores[i].capacity() == 0 && !stores[i].allocate(WATCHLIST_BARS)) {
+      LOG_E("Not enough PSRAM for watchlist history");
+      symbol_count = i;
+      break;
+    }
+    stores[i].clear();
+    prices[i] = 0.0;
+    previous_closes[i] = 0.0;
+  }
+
+  watch_request_t request;
+  request.generation = generation;
+  strlcpy(request.symbols, list.c_str(), sizeof(request.symbols));
+
+  portENTER_CRITICAL(&request_lock);
+  pending = request;
+  request_pending = true;
+  portEXIT_CRITICAL(&request_lock);
+
+  LOG_I("Watchlist: %d symbols", symbol_count);
+}
+
+float Watchlist::changePercent(int i) {
+  if (previous_closes[i] <= 0 || prices[i] <= 0) {
+    return 0.0;
+  }
+  return (prices[i] - previous_closes[i]) * 100.0f / previous_closes[i];
+}
+
+void Watchlist::applyPoint(const quote_point_t &point) {
+  if (point.symbol >= symbol_count) {
+    return;
+  }
+
+  CandleStore &history = stores[point.symbol];
+  prices[point.symbol] = point.price;
+  if (point.previous_close > 0) {
+    previous_closes[point.symbol] = point.previous_close;
+  }
+
+  // Spark points carry a close only; a repeated timestamp is the forming
+  // bar being refreshed
+  if (history.size() > 0 && point.timestamp == history.timestamp(0)) {
+    enhanced_candle_t current = history.get(0);
+    current.close = point.price;
+    current.high = std::max(current.high, point.price);
+    current.low = std::min(current.low, point.price);
+    history.replace(0, current);
+  } else if (history.size() == 0 || point.timestamp > history.timestamp(0)) {
+    enhanced_candle_t candle;
+    candle.open = point.price;
+    candle.high = point.price;
+    candle.low = point.price;
+    candle.close = point.price;
+    candle.volume = 0;
+    candle.timestamp = point.timestamp;
+    candle.is_complete = true;
+    history.push(candle);
+  }
+}
+
+bool Watchlist::applyPending() {
+  bool changed = false;
+  quote_batch_t *batch;
+  while ((batch = batches.front()) != NULL) {
+    if (batch->generation == generation) {
+      for (int i = 0; i < batch->count; i++) {
+        applyPoint(batch->points[i]);
+      }
+      changed = true;
+    }
+    batches.pop();
+  }
+  return changed;
+}
+
+const JsonDocument &Watchlist::sparkFilter() {
+  // Built once; only the fields poll() reads are kept in the DOM
+  static JsonDocument filter;
+  if (filter.isNull()) {
+    JsonObject result = filter["spark"]["result"].add<JsonObject>();
+    result["symbol"] = true;
+    JsonObject chart = result["response"].add<JsonObject>();
+    chart["meta"]["chartPreviousClose"] = true;
+    chart["timestamp"] = true;
+    chart["indicators"]["quote"].add<JsonObject>()["close"] = true;
+  }
+  return filter;
+}
+
+quote_batch_t *Watchlist::beginBatch() {
+  quote_batch_t *batch = FetchTask::waitForSlot(batches);
+  batch->generation = active.generation;
+  batch->count = 0;
+  return batch;
+}
+
+bool Watchlist::takeRequest() {
+  if (!request_pending) {
+    return false;
+  }
+  portENTER_CRITICAL(&request_lock);
+  active = pending;
+  request_pending = false;
+  portEXIT_CRITICAL(&request_lock);
+  return true;
+}
+
+void Watchlist::pollIfDue() {
+  if (takeRequest()) {
+    active_count = split(active.symbols, active_symbols);
+    memset(sent_newest, 0, sizeof(sent_newest));
+    last_poll = 0;
+  }
+
+  if (active_count == 0 ||
+      (last_poll != 0 && millis() - last_poll < WATCHLIST_POLL_MS)) {
+    return;
+  }
+  last_poll = millis();
+  poll();
+}
+
+bool Watchlist::poll() {
+  String url = String(FetchTask::baseUrl()) +
+               "/v7/finance/spark?symbols=" + active.symbols +
+               "&range=1d&interval=5m";
+
+  unsigned long start = millis();
+  int httpCode = HttpSession::get(url);
+
+  if (httpCode != HTTP_CODE_OK) {
+    LOG_W("Watchlist request failed with code: %d", httpCode);
+    HttpSession::end();
+    return false;
+  }
+
+  uint32_t heap_before = ESP.getFreeHeap();
+  JsonDocument doc;
+  DeserializationError error =
+      deserializeJson(doc, HttpSession::body(),
+                      DeserializationOption::Filter(sparkFilter()));
+  HttpSession::end();
+  int dom_bytes = (int)heap_before - (int)ESP.getFreeHeap();
+  if (error) {
+    LOG_W("Watchlist JSON parsing failed: %s", error.c_str());
+    return false;
+  }
+
+  quote_batch_t *batch = NULL;
+  int points = 0;
+
+  for (JsonObject result : doc["spark"]["result"].as<JsonArray>()) {
+    const char *name = result["symbol"];
+    int index = -1;
+    for (int i = 0; i < active_count && name != NULL; i++) {
+      if (strcmp(active_symbols[i], name) == 0) {
+        index = i;
+        break;
+      }
+    }
+    if (index < 0) {
+      continue;
+    }
+
+    JsonObject chart = result["response"][0];
+    JsonArray timestamps = chart["timestamp"];
+    JsonArray closes = chart["indicators"]["quote"][0]["close"];
+    float previous_close = chart["meta"]["chartPreviousClose"] | 0.0f;
+
+    // Only points at or after the newest one sent; the last is still forming.
+    // Arrays are walked with iterators since indexing one is linear.
+    JsonArray::iterator close_it = closes.begin();
+    for (JsonVariant value : timestamps) {
+      time_t timestamp = value.as<long>();
+      float close = 0.0;
+      if (close_it != closes.end()) {
+        close = *close_it | 0.0f;
+        ++close_it;
+      }
+      if (close <= 0 || timestamp < sent_newest[index]) {
+        continue;
+      }
+
+      if (batch == NULL) {
+        batch = beginBatch();
+      }
+      quote_point_t &point = batch->points[batch->count++];
+      point.symbol = index;
+      point.price = close;
+      point.previous_close = previous_close;
+      point.timestamp = timestamp;
+      sent_newest[index] = timestamp;
+      points++;
+
+      if (batch->count == QUOTE_BATCH_SIZE) {
+        batches.commitPush();
+        batch = NULL;
+      }
+    }
+  }
+
+  if (batch != NULL) {
+    batches.commitPush();
+  }
+
+  LOG_D("Watchlist poll: %d symbols, %d points in %lu ms (DOM: %d bytes)",
+        active_count, points, millis() - start, dom_bytes);
+  return true;
+}
@@ -0,0 +1,83 @@
+#ifndef WATCHLIST_H
+#define WATCHLIST_H
+
+#include "candle_store.h"
+#include "config.h"
+#include "spsc_queue.h"
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+#include <time.h>
+
+#define WATCHLIST_BARS 96         // 5m points kept per symbol (8 hours)
+#define WATCHLIST_POLL_MS 15000   // One batched request per period
+#define QUOTE_BATCH_SIZE 32
+
+typedef struct {
+  uint8_t symbol; // Index into the watchlist
+  float price;
+  float previous_close;
+  time_t timestamp;
+} quote_point_t;
+
+// Quote points handed from the network task to the UI core in one slot
+typedef struct {
+  uint32_t generation; // Watchlist configuration this batch answers
+  uint8_t count;
+  quote_point_t points[QUOTE_BATCH_SIZE];
+} quote_batch_t;
+
+typedef struct {
+  uint32_t generation;
+  char symbols[WATCHLIST_CHARS]; // Comma-separated, already normalized
+} watch_request_t;
+
+// Quotes every watchlist symbol with a single spark request per poll, so a
+// poll costs one round trip and one TLS session whatever the list length.
+// Results fan out into a small CandleStore per symbol on the UI core. Edits
+// reach the network task through a one-slot mailbox like FetchTask's, so
+// however many arrive before a poll, the newest list is the one quoted.
+class Watchlist {
+private:
+  // UI core
+  static char symbols[WATCHLIST_MAX_SYMBOLS][16];
+  static int symbol_count;
+  static CandleStore stores[WATCHLIST_MAX_SYMBOLS];
+  static float prices[WATCHLIST_MAX_SYMBOLS];
+  static float previous_closes[WATCHLIST_MAX_SYMBOLS];
+  static uint32_t generation;
+
+  static portMUX_TYPE request_lock;
+  static watch_request_t pending; // Under request_lock
+  static std::atomic<bool> request_pending;
+  static SpscQueue<quote_batch_t, 2> batches;
+
+  // Network core
+  static watch_request_t active;
+  static char active_symbols[WATCHLIST_MAX_SYMBOLS][16];
+  static int active_count;
+  static time_t sent_newest[WATCHLIST_MAX_SYMBOLS];
+  static unsigned long last_poll;
+
+  static int split(const char *list, char out[][16]);
+  static void applyPoint(const quote_point_t &point);
+  static bool takeRequest();
+  static quote_batch_t *beginBatch();
+  static const JsonDocument &sparkFilter();
+  static bool poll();
+
+public:
+  // UI core
+  static void configure(const String &list);
+  static bool applyPending();
+  static int count() { return symbol_count; }
+  static const char *symbol(int i) { return symbols[i]; }
+  static float price(int i) { return prices[i]; }
+  static float changePercent(int i);
+  static const CandleStore &store(int i) { return stores[i]; }
+
+  // Network core
+  static void pollIfDue();
+};
+
+#endif // WATCHLIST_H
@@ -1,6 +1,17 @@
 #include "web_server.h"
+#include "candle_export.h"
 #include "config.h"
+#include "data_fetcher.h"
+#include "enhanced_candle_stick.h"
+#include "event_stream.h"
+#include "http_session.h"
+#include "log.h"
+#include "metrics.h"
+#include "watchlist.h"
+#include <ArduinoJson.h>
+#include <LV_Helper.h>
 #include <WiFi.h>
+#include <lvgl.h>
 
 // Static member definitions
 WebServer StockWebServer::server(80);
@@ -8,7 +19,7 @@ bool StockWebServer::serverStarted = false;
 
 bool StockWebServer::begin(int port) {
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("WiFi not connected, cannot start web server");
+    LOG_W("WiFi not connected, cannot start web server");
     return false;
   }
 
@@ -16,6 +27,11 @@ bool StockWebServer::begin(int port) {
   server.on("/", HTTP_GET, handleRoot);
   server.on("/config", HTTP_GET, handleGetConfig);
   server.on("/config", HTTP_POST, handleSetConfig);
+  server.on("/watchlist", HTTP_GET, handleGetWatchlist);
+  server.on("/events", HTTP_GET, handleEvents);
+  server.on("/candles.bin", HTTP_GET, handleCandlesBin);
+  server.on("/candles.csv", HTTP_GET, handleCandlesCsv);
+  server.on("/metrics", HTTP_GET, handleMetrics);
   server.onNotFound(handleNotFound);
 
   // Enable CORS
@@ -24,21 +40,24 @@ bool StockWebServer::begin(int port) {
   server.begin();
   serverStarted = true;
 
-  Serial.println("Web server started on http://" + WiFi.localIP().toString());
+  LOG_I("Web server started on http://%s",
+        WiFi.localIP().toString().c_str());
   return true;
 }
 
 void StockWebServer::handleClient() {
   if (serverStarted) {
     server.handleClient();
+    EventStream::service();
   }
 }
 
 void StockWebServer::stop() {
   if (serverStarted) {
+    EventStream::closeAll();
     server.stop();
     serverStarted = false;
-    Serial.println("Web server stopped");
+    LOG_I("Web server stopped");
   }
 }
 
@@ -51,14 +70,26 @@ void StockWebServer::handleGetConfig() {
   server.send(200, "application/json", config);
 }
 
+// Settings read once at boot, when WiFi comes up
+static String networkSettings() {
+  return String(USE_STATIC_IP) + "," + STATIC_IP + "," + GATEWAY_IP + "," +
+         SUBNET_MASK;
+}
+
 void StockWebServer::handleSetConfig() {
   if (server.hasArg("plain")) {
     String body = server.arg("plain");
-    Serial.println("Received config: " + body);
+    LOG_D("Received config: %s", body.c_str());
 
+    String network = networkSettings();
     if (setConfigFromJSON(body)) {
+      // Network edits only apply after a restart, which the page asks
+      // for; write them now so a power cycle inside the debounce keeps them
+      if (networkSettings() != network) {
+        flushConfig();
+      }
       server.send(200, "application/json", "{\"status\":\"success\"}");
-      Serial.println("Configuration updated successfully");
+      LOG_I("Configuration updated successfully");
     } else {
       server.send(400, "application/json", "{\"status\":\"error\"}");
     }
@@ -67,6 +98,215 @@ void StockWebServer::handleSetConfig() {
   }
 }
 
+void StockWebServer::handleGetWatchlist() {
+  JsonDocument doc;
+  JsonArray quotes = doc.to<JsonArray>();
+
+  for (int i = 0; i < Watchlist::count(); i++) {
+    JsonObject quote = quotes.add<JsonObject>();
+    quote["symbol"] = Watchlist::symbol(i);
+    quote["price"] = Watchlist::price(i);
+    quote["changePercent"] = Watchlist::changePercent(i);
+    quote["bars"] = Watchlist::store(i).size();
+  }
+
+  String json;
+  serializeJson(doc, json);
+  server.send(200, "application/json", json);
+}
+
+void StockWebServer::handleEvents() {
+  // The stream outlives this request; the server's own reference to the
+  // socket is dropped once it goes back to waiting for connections
+  EventStream::accept(server.client());
+}
+
+int StockWebServer::exportBarCount() {
+  const CandleStore &store = DataFetcher::getStore();
+  if (!server.hasArg("since")) {
+    return store.size();
+  }
+  return store.countSince((time_t)strtoll(server.arg("since").c_str(), NULL,
+                                          10));
+}
+
+void StockWebServer::sendChunk(const uint8_t *data, size_t len, void *ctx) {
+  server.sendContent((const char *)data, len);
+}
+
+void StockWebServer::handleCandlesBin() {
+  unsigned long start = millis();
+  int bars = exportBarCount();
+
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/octet-stream", "");
+  size_t bytes =
+      CandleExport::write(DataFetcher::getStore(), STOCK_SYMBOL.c_str(),
+                          YAHOO_INTERVAL.c_str(), bars, sendChunk, NULL);
+  server.sendContent("");
+
+  LOG_I("Exported %d bars (%u bytes) in %lu ms", bars, (unsigned)bytes,
+        millis() - start);
+}
+
+void StockWebServer::handleCandlesCsv() {
+  unsigned long start = millis();
+  const CandleStore &store = DataFetcher::getStore();
+  int bars = exportBarCount();
+
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/csv", "");
+
+  // Rows are formatted into one small buffer and sent as it fills
+  char buf[1024];
+  int len = snprintf(buf, sizeof(buf),
+                     "time,open,high,low,close,volume,complete\n");
+  for (int age = bars - 1; age >= 0; age--) {
+    if (len > (int)sizeof(buf) - 128) {
+      server.sendContent(buf, len);
+      len = 0;
+    }
+    enhanced_candle_t c = store.get(age);
+    len += snprintf(buf + len, sizeof(buf) - len,
+                    "%ld,%.4f,%.4f,%.4f,%.4f,%u,%d\n", (long)c.timestamp,
+                    c.open, c.high, c.low, c.close, c.volume,
+                    c.is_complete ? 1 : 0);
+  }
+  server.sendContent(buf, len);
+  server.sendContent("");
+
+  LOG_I("Exported %d bars as CSV in %lu ms", bars, millis() - start);
+}
+
+// Objects under `obj`, itself included
+static uint32_t countObjects(lv_obj_t *obj) {
+  uint32_t count = 1;
+  uint32_t children = lv_obj_get_child_cnt(obj);
+  for (uint32_t i = 0; i < children; i++) {
+    count += countObjects(lv_obj_get_child(obj, i));
+  }
+  return count;
+}
+
+// One gauge or counter in Prometheus text format
+static int formatMetric(char *buf, size_t size, const char *name,
+                        const char *type, const char *help, double value) {
+  return snprintf(buf, size, "# HELP %s %s\n# TYPE %s %s\n%s %.0f\n", name,
+                  help, name, type, name, value);
+}
+
+void StockWebServer::handleMetrics() {
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/plain; version=0.0.4", "");
+
+  // Same as the CSV export: one small buffer, sent whenever it fills
+  char buf[1024];
+  int len = snprintf(buf, sizeof(buf),
+                     "# HELP ticker_stage_seconds Time spent per update "
+                     "pipeline stage\n"
+                     "# TYPE ticker_stage_seconds histogram\n");
+  for (int s = 0; s < METRIC_STAGE_COUNT; s++) {
+    const metric_histogram_t &h = Metrics::getHistogram((MetricStage)s);
+    const char *stage = Metrics::stageName((MetricStage)s);
+
+    // Counted from the buckets so a sample recorded mid-read on the other
+    // core cannot make +Inf and _count disagree
+    uint32_t count = 0;
+    for (int b = 0; b <= METRIC_BUCKET_COUNT; b++) {
+      if (len > (int)sizeof(buf) - 256) {
+        server.sendContent(buf, len);
+        len = 0;
+      }
+      count += h.buckets[b];
+      char le[16] = "+Inf";
+      if (b < METRIC_BUCKET_COUNT) {
+        snprintf(le, sizeof(le), "%g", Metrics::bucketBound(b) / 1e6);
+      }
+      len += snprintf(buf + len, sizeof(buf) - len,
+                      "ticker_stage_seconds_bucket{stage=\"%s\",le=\"%s\"} "
+                      "%u\n",
+                      stage, le, count);
+    }
+    len += snprintf(buf + len, sizeof(buf) - len,
+                    "ticker_stage_seconds_sum{stage=\"%s\"} %.6f\n"
+                    "ticker_stage_seconds_count{stage=\"%s\"} %u\n",
+                    stage, h.sum_us / 1e6, stage, count);
+  }
+  server.sendContent(buf, len);
+
+  len = snprintf(buf, sizeof(buf),
+                 "# HELP ticker_stage_max_seconds Slowest sample per stage\n"
+                 "# TYPE ticker_stage_max_seconds gauge\n");
+  for (int s = 0; s < METRIC_STAGE_COUNT; s++) {
+    len += snprintf(buf + len, sizeof(buf) - len,
+                    "ticker_stage_max_seconds{stage=\"%s\"} %.6f\n",
+                    Metrics::stageName((MetricStage)s),
+                    Metrics::getHistogram((MetricStage)s).max_us / 1e6);
+  }
+  server.sendContent(buf, len);
+
+  // Memory: the IDF keeps the low-water marks, so these cost nothing
+  len = formatMetric(buf, sizeof(buf), "ticker_heap_size_bytes", "gauge",
+                     "Internal heap size", ESP.getHeapSize());
+  len += formatMetric(buf + len, sizeof(buf) - len, "ticker_heap_free_bytes",
+                      "gauge", "Free internal heap", ESP.getFreeHeap());
+  len += formatMetric(buf + len, sizeof(buf) - len,
+                      "ticker_heap_min_free_bytes", "gauge",
+                      "Lowest free internal heap since boot",
+                      ESP.getMinFreeHeap());
+  len += formatMetric(buf + len, sizeof(buf) - len,
+                      "ticker_heap_max_alloc_bytes", "gauge",
+                      "Largest free internal heap block",
+                      ESP.getMaxAllocHeap());
+  server.sendContent(buf, len);
+  len = formatMetric(buf, sizeof(buf), "ticker_psram_size_bytes", "gauge",
+                     "PSRAM size", ESP.getPsramSize());
+  len += formatMetric(buf + len, sizeof(buf) - len, "ticker_psram_free_bytes",
+                      "gauge", "Free PSRAM", ESP.getFreePsram());
+  len += formatMetric(buf + len, sizeof(buf) - len,
+                      "ticker_psram_min_free_bytes", "gauge",
+                      "Lowest free PSRAM since boot", ESP.getMinFreePsram());
+  server.sendContent(buf, len);
+
+  // LVGL and the renderer; the web server runs in loop(), so the object
+  // tree is safe to walk here
+  const render_stats_t &render = EnhancedCandleStick::getRenderStats();
+  const lv_helper_flush_stats_t &flush = lvglHelperFlushStats();
+  uint32_t objects = countObjects(lv_scr_act()) + countObjects(lv_layer_top()) +
+                     countObjects(lv_layer_sys());
+  len = formatMetric(buf, sizeof(buf), "ticker_lvgl_objects", "gauge",
+                     "LVGL objects on the active screen and layers", objects);
+  len += formatMetric(buf + len, sizeof(buf) - len,
+                      "ticker_lvgl_objects_created_total", "counter",
+                      "LVGL objects allocated by the chart",
+                      render.objects_created);
+  len += formatMetric(buf + len, sizeof(buf) - len,
+                      "ticker_chart_rebuilds_total", "counter",
+                      "Full chart rebuilds", render.rebuilds);
+  len += formatMetric(buf + len, sizeof(buf) - len,
+                      "ticker_lvgl_frames_total", "counter",
+                      "Frames flushed to the panel", flush.frames);
+  server.sendContent(buf, len);
+
+  // Written by the fetch task; a torn read only skews one scrape
+  const http_session_stats_t &net = HttpSession::getStats();
+  len = formatMetric(buf, sizeof(buf), "ticker_http_requests_total",
+                     "counter", "Data requests sent", net.requests);
+  len += formatMetric(buf + len, sizeof(buf) - len,
+                      "ticker_http_handshakes_total", "counter",
+                      "Fresh connections opened", net.handshakes);
+  len += formatMetric(buf + len, sizeof(buf) - len,
+                      "ticker_http_failures_total", "counter",
+                      "Requests with no response", net.failures);
+  len += formatMetric(buf + len, sizeof(buf) - len,
+                      "ticker_http_rejected_total", "counter",
+                      "Responses with a status other than 200", net.rejected);
+  len += formatMetric(buf + len, sizeof(buf) - len, "ticker_uptime_seconds",
+                      "gauge", "Seconds since boot", millis() / 1000);
+  server.sendContent(buf, len);
+  server.sendContent("");
+}
+
 void StockWebServer::handleNotFound() {
   server.send(404, "text/plain", "Not found");
 }
@@ -147,6 +387,11 @@ button:hover{background:#0056b3}
 <span class="symbol-button" onclick="setSymbol('ETH-USD')">ETH-USD</span>
 </div>
 </div>
+<div class="form-group">
+<label>Watchlist:</label>
+<input type="text" id="watchlist" class="symbol-input" maxlength="71" placeholder="e.g. AAPL,MSFT,NVDA">
+<div class="symbol-help" id="watchlistHelp">Comma-separated symbols, quoted together in one request.</div>
+</div>
 <div class="form-row">
 <div class="form-group">
 <label>Interval:</label>
@@ -182,6 +427,13 @@ Max bars depends on screen resolution and data buffer
 </div>
 </div>
 
+<div class="form-group">
+<div class="checkbox-group">
+<input type="checkbox" id="canvasRenderer">
+<label>Canvas Renderer (draw candles into one bitmap)</label>
+</div>
+</div>
+
 <div class="form-group">
 <div id="candleDurationInfo" style="background:#e3f2fd;padding:10px;border-radius:4px;font-size:12px;color:#1565c0;">
 <strong>Candle Duration:</strong> Auto-synced with interval (<span id="computedDuration">120</span> seconds)
@@ -191,6 +443,20 @@ Max bars depends on screen resolution and data buffer
 
 <h2>Data Options</h2>
 <div class="form-group">
+<label>History Bars:</label>
+<input type="number" id="historyBars" min="100" max="50000" value="2000" style="width:120px;">
+<div style="font-size:12px;color:#666;margin-top:5px;">
+Bars kept in PSRAM (e.g. 1950 holds 5 days of 1m bars). Changing it reloads the data.
+</div>
+</div>
+<div class="form-group">
+<label>Data Source URL:</label>
+<input type="text" id="dataBaseUrl" maxlength="63" style="width:100%;" placeholder="https://query1.finance.yahoo.com">
+<div style="font-size:12px;color:#666;margin-top:5px;">
+Yahoo Finance, or a plain-HTTP stand-in such as tools/yahoo_standin.py. Changing it reloads the data.
+</div>
+</div>
+<div class="form-group">
 <div class="checkbox-group">
 <input type="checkbox" id="useTestData">
 <label>Use Test Data</label>
@@ -350,6 +616,12 @@ if (updateMs < 1000) {
 
 document.getElementById('barsToShow').value = config.barsToShow || 50;
 document.getElementById('testUpdatesPerBar').value = config.testUpdatesPerBar || 10;
+document.getElementById('historyBars').value = config.historyBars || 2000;
+document.getElementById('historyBars').min = config.minHistoryBars || 100;
+document.getElementById('historyBars').max = config.maxHistoryBars || 50000;
+document.getElementById('watchlist').value = config.watchlist || '';
+document.getElementById('dataBaseUrl').value = config.dataBaseUrl || '';
+document.getElementById('watchlistHelp').textContent = `Up to ${config.maxWatchlist || 8} comma-separated symbols, quoted together in one request.`;
 
 const computedDuration = config.computedCandleDuration || 120;
 document.getElementById('computedDuration').textContent = computedDuration;
@@ -361,6 +633,7 @@ document.getElementById('barsHelpText').textContent = helpText;
 
 document.getElementById('useTestData').checked = config.useTestData || false;
 document.getElementById('enforceHours').checked = config.enforceHours !== false;
+document.getElementById('canvasRenderer').checked = config.canvasRenderer || false;
 
 // Show/hide test data options
 const testOptions = document.getElementById('testDataOptions');
@@ -455,8 +728,12 @@ yahooInterval: document.getElementById('yahooInterval').value,
 yahooRange: document.getElementById('yahooRange').value,
 updateInterval: updateInterval, // Now in milliseconds
 barsToShow: barsToShow,
+canvasRenderer: document.getElementById('canvasRenderer').checked,
 useTestData: document.getElementById('useTestData').checked,
 testUpdatesPerBar: updatesPerBar,
+historyBars: parseInt(document.getElementById('historyBars').value),
+watchlist: document.getElementById('watchlist').value,
+dataBaseUrl: document.getElementById('dataBaseUrl').value,
 enforceHours: document.getElementById('enforceHours').checked,
 useStaticIP: document.getElementById('useStaticIP').checked,
 staticIP: document.getElementById('staticIP').value,
@@ -13,6 +13,13 @@ private:
     static void handleRoot();
     static void handleGetConfig();
     static void handleSetConfig();
+    static void handleGetWatchlist();
+    static void handleEvents();
+    static void handleCandlesBin();
+    static void handleCandlesCsv();
+    static void sendChunk(const uint8_t *data, size_t len, void *ctx);
+    static void handleMetrics();
+    static int exportBarCount();
     static void handleNotFound();
     static String generateHTML();
     
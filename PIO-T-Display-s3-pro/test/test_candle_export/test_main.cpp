@@ -0,0 +1,158 @@
+// CandleExport::write() decoded against the /candles.bin layout documented
+// in candle_export.h, whole and with ?since=, over a wrapped ring
+//
+//   pio test -e native_test -f test_candle_export
+
+#include "candle_export.h"
+#include "candle_store.h"
+#include <algorithm>
+#include <unity.h>
+#include <vector>
+
+#define SLOTS 300
+#define BARS 1000 // Wraps the ring three times over
+#define START_TIME 1700000000
+#define STEP 60
+
+static CandleStore store;
+
+static void appendChunk(const uint8_t *data, size_t len, void *ctx) {
+  std::vector<uint8_t> *out = (std::vector<uint8_t> *)ctx;
+  out->insert(out->end(), data, data + len);
+}
+
+static void fillStore() {
+  store.allocate(SLOTS);
+  float price = 250.0f;
+  for (int i = 0; i < BARS; i++) {
+    float next = price * (1.0f + (float)((i * 7919) % 201 - 100) / 20000.0f);
+    enhanced_candle_t candle;
+    candle.timestamp = START_TIME + i * STEP;
+    candle.open = price;
+    candle.close = next;
+    candle.high = std::max(price, next) + 0.05f;
+    candle.low = std::min(price, next) - 0.05f;
+    candle.volume = 1000 + (i * 31) % 9000;
+    candle.is_complete = i < BARS - 1;
+    // Quiet minutes arrive as missing prices
+    if (i % 97 == 96) {
+      candle.open = candle.high = candle.low = candle.close = 0;
+    }
+    store.push(candle);
+    price = next;
+  }
+}
+
+static float priceOf(const candle_export_header_t &header, int32_t ticks) {
+  if (ticks == INT32_MIN) {
+    return 0;
+  }
+  return header.base_price + (double)ticks / header.price_scale;
+}
+
+// Decodes `image` the way a client would and checks it holds the newest
+// `bars` bars of the store, oldest first
+static void checkImage(const std::vector<uint8_t> &image, int bars) {
+  candle_export_header_t header;
+  TEST_ASSERT_TRUE(image.size() >= sizeof(header));
+  memcpy(&header, image.data(), sizeof(header));
+  TEST_ASSERT_EQUAL(CANDLE_EXPORT_MAGIC, header.magic);
+  TEST_ASSERT_EQUAL(CANDLE_EXPORT_VERSION, header.version);
+  TEST_ASSERT_EQUAL(sizeof(header), header.header_size);
+  TEST_ASSERT_EQUAL_STRING("SPY", header.symbol);
+  TEST_ASSERT_EQUAL_STRING("1m", header.interval);
+  TEST_ASSERT_EQUAL(bars, header.count);
+  TEST_ASSERT_EQUAL(CANDLE_PRICE_SCALE, header.price_scale);
+  TEST_ASSERT_EQUAL(CandleExport::encodedSize(bars), image.size());
+
+  // Column after column, at the offsets the layout implies
+  const uint8_t *at = image.data() + header.header_size;
+  const int32_t *open = (const int32_t *)at;
+  const int32_t *high = open + bars;
+  const int32_t *low = high + bars;
+  const int32_t *close = low + bars;
+  const uint32_t *time = (const uint32_t *)(close + bars);
+  const uint32_t *volume = time + bars;
+  const uint8_t *complete = (const uint8_t *)(volume + bars);
+  TEST_ASSERT_TRUE(complete + bars == image.data() + image.size());
+
+  for (int i = 0; i < bars; i++) {
+    enhanced_candle_t expected = store.get(bars - 1 - i);
+    TEST_ASSERT_EQUAL(expected.timestamp, header.base_time + time[i]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, expected.open, priceOf(header, open[i]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, expected.high, priceOf(header, high[i]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, expected.low, priceOf(header, low[i]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, expected.close, priceOf(header, close[i]));
+    if (expected.close == 0) {
+      TEST_ASSERT_EQUAL(INT32_MIN, close[i]);
+    }
+    TEST_ASSERT_EQUAL(expected.volume, volume[i]);
+    TEST_ASSERT_EQUAL(expected.is_complete ? 1 : 0, complete[i]);
+  }
+}
+
+static std::vector<uint8_t> exportBars(int bars) {
+  std::vector<uint8_t> image;
+  size_t bytes = CandleExport::write(store, "SPY", "1m", bars, appendChunk,
+                                     &image);
+  TEST_ASSERT_EQUAL(image.size(), bytes);
+  return image;
+}
+
+void setUp() { fillStore(); }
+void tearDown() {}
+
+void test_whole_store_decodes() {
+  checkImage(exportBars(store.size()), SLOTS);
+  // Asking for more than is stored sends what there is
+  checkImage(exportBars(SLOTS + 50), SLOTS);
+  checkImage(exportBars(0), 0);
+}
+
+void test_since_across_the_wrap() {
+  int starts[2], lengths[2];
+  TEST_ASSERT_EQUAL(2, store.runs(SLOTS, starts, lengths));
+  time_t newest = store.timestamp(0);
+  time_t oldest = store.timestamp(SLOTS - 1);
+
+  // On a bar, between bars, both ends, and either side of the ring seam
+  int seam_age = lengths[1];
+  const time_t sinces[] = {
+      oldest - 1,
+      oldest,
+      oldest + STEP / 2,
+      store.timestamp(seam_age),
+      store.timestamp(seam_age - 1),
+      store.timestamp(seam_age + 1) + 1,
+      newest - 1,
+      newest,
+      newest + STEP,
+  };
+  for (time_t since : sinces) {
+    int bars = store.countSince(since);
+    int expected = 0;
+    for (int i = BARS - SLOTS; i < BARS; i++) {
+      expected += (START_TIME + i * STEP > since) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL(expected, bars);
+
+    std::vector<uint8_t> image = exportBars(bars);
+    checkImage(image, bars);
+    if (bars > 0) {
+      candle_export_header_t header;
+      memcpy(&header, image.data(), sizeof(header));
+      const uint32_t *time =
+          (const uint32_t *)(image.data() + sizeof(header) +
+                             4 * bars * sizeof(int32_t));
+      TEST_ASSERT_TRUE(header.base_time + time[0] > since);
+      TEST_ASSERT_EQUAL(newest, header.base_time + time[bars - 1]);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_whole_store_decodes);
+  RUN_TEST(test_since_across_the_wrap);
+  return UNITY_END();
+}
@@ -0,0 +1,92 @@
+// Synthetic SPY minutes around the 2024-03-12 open (06:30 PDT, 13:30 UTC):
+// 1m bars from 06:22 to 07:07 local with a null bar at 06:41, and the 5m
+// and 15m bars they make when labelled from the open, as Yahoo does. The
+// last coarse bar of each is still open.
+
+#ifndef FIXTURES_H
+#define FIXTURES_H
+
+#include <stdint.h>
+#include <time.h>
+
+typedef struct {
+  time_t timestamp;
+  float open;
+  float high;
+  float low;
+  float close;
+  uint32_t volume;
+} fixture_bar_t;
+
+#define SESSION_OPEN 1710250200 // 2024-03-12 06:30 PDT
+
+static const fixture_bar_t bars_1m[] = {
+    {1710249720, 512.40, 512.44, 512.18, 512.30, 383},
+    {1710249780, 512.30, 512.32, 512.00, 512.03, 237},
+    {1710249840, 512.03, 512.11, 511.97, 512.10, 69},
+    {1710249900, 512.10, 512.23, 511.72, 511.85, 85},
+    {1710249960, 511.85, 511.87, 511.57, 511.70, 80},
+    {1710250020, 511.70, 511.95, 511.63, 511.92, 372},
+    {1710250080, 511.92, 512.03, 511.80, 512.02, 75},
+    {1710250140, 512.02, 512.03, 511.82, 511.86, 198},
+    {1710250200, 511.86, 511.90, 511.79, 511.82, 6676},
+    {1710250260, 511.82, 511.87, 511.68, 511.71, 6764},
+    {1710250320, 511.71, 511.83, 511.60, 511.77, 2798},
+    {1710250380, 511.77, 511.84, 511.76, 511.82, 7070},
+    {1710250440, 511.82, 511.97, 511.52, 511.65, 8367},
+    {1710250500, 511.65, 511.79, 511.41, 511.55, 4962},
+    {1710250560, 511.55, 511.62, 511.39, 511.44, 7726},
+    {1710250620, 511.44, 511.70, 511.42, 511.63, 6705},
+    {1710250680, 511.63, 511.78, 511.42, 511.52, 7975},
+    {1710250740, 511.52, 511.61, 511.48, 511.50, 2967},
+    {1710250800, 511.50, 511.65, 511.45, 511.52, 8202},
+    {1710250860, 0.00, 0.00, 0.00, 0.00, 0},
+    {1710250920, 511.52, 511.56, 511.28, 511.43, 5454},
+    {1710250980, 511.43, 511.45, 511.05, 511.15, 4786},
+    {1710251040, 511.15, 511.40, 511.00, 511.29, 6750},
+    {1710251100, 511.29, 511.64, 511.27, 511.50, 8881},
+    {1710251160, 511.50, 511.58, 511.10, 511.25, 7710},
+    {1710251220, 511.25, 511.39, 511.24, 511.37, 7989},
+    {1710251280, 511.37, 511.60, 511.23, 511.51, 4331},
+    {1710251340, 511.51, 511.78, 511.40, 511.66, 2184},
+    {1710251400, 511.66, 512.10, 511.55, 511.96, 3376},
+    {1710251460, 511.96, 512.08, 511.81, 512.05, 2482},
+    {1710251520, 512.05, 512.14, 511.84, 511.88, 8048},
+    {1710251580, 511.88, 512.00, 511.61, 511.73, 6067},
+    {1710251640, 511.73, 511.78, 511.34, 511.48, 5290},
+    {1710251700, 511.48, 511.61, 511.44, 511.53, 8711},
+    {1710251760, 511.53, 511.61, 511.37, 511.50, 4939},
+    {1710251820, 511.50, 511.75, 511.43, 511.63, 3236},
+    {1710251880, 511.63, 511.68, 511.34, 511.38, 3900},
+    {1710251940, 511.38, 511.57, 511.38, 511.50, 5972},
+    {1710252000, 511.50, 511.78, 511.42, 511.73, 4309},
+    {1710252060, 511.73, 511.77, 511.30, 511.43, 6379},
+    {1710252120, 511.43, 511.53, 511.32, 511.36, 7656},
+    {1710252180, 511.36, 511.61, 511.22, 511.60, 8389},
+    {1710252240, 511.60, 512.02, 511.48, 511.90, 5268},
+    {1710252300, 511.90, 511.93, 511.70, 511.85, 7196},
+    {1710252360, 511.85, 511.86, 511.74, 511.80, 2551},
+    {1710252420, 511.80, 511.94, 511.58, 511.63, 2900},
+};
+
+static const fixture_bar_t bars_5m[] = {
+    {1710249600, 512.40, 512.44, 511.97, 512.10, 689},
+    {1710249900, 512.10, 512.23, 511.57, 511.86, 810},
+    {1710250200, 511.86, 511.97, 511.52, 511.65, 31675},
+    {1710250500, 511.65, 511.79, 511.39, 511.50, 30335},
+    {1710250800, 511.50, 511.65, 511.00, 511.29, 25192},
+    {1710251100, 511.29, 511.78, 511.10, 511.66, 31095},
+    {1710251400, 511.66, 512.14, 511.34, 511.48, 25263},
+    {1710251700, 511.48, 511.75, 511.34, 511.50, 26758},
+    {1710252000, 511.50, 512.02, 511.22, 511.90, 32001},
+    {1710252300, 511.90, 511.94, 511.58, 511.63, 12647},
+};
+
+static const fixture_bar_t bars_15m[] = {
+    {1710249300, 512.40, 512.44, 511.57, 511.86, 1499},
+    {1710250200, 511.86, 511.97, 511.00, 511.29, 87202},
+    {1710251100, 511.29, 512.14, 511.10, 511.50, 83116},
+    {1710252000, 511.50, 512.02, 511.22, 511.63, 44648},
+};
+
+#endif // FIXTURES_H
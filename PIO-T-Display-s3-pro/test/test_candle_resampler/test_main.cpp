@@ -0,0 +1,94 @@
+// CandleResampler::rebuild() from a 1m fixture against its 5m and 15m bars
+//
+//   pio test -e native_test -f test_candle_resampler
+
+#include "candle_resampler.h"
+#include "fixtures.h"
+#include <unity.h>
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static CandleStore fine;
+static CandleStore coarse;
+
+static void loadFine() {
+  fine.clear();
+  for (size_t i = 0; i < COUNT(bars_1m); i++) {
+    enhanced_candle_t c;
+    c.open = bars_1m[i].open;
+    c.high = bars_1m[i].high;
+    c.low = bars_1m[i].low;
+    c.close = bars_1m[i].close;
+    c.volume = bars_1m[i].volume;
+    c.timestamp = bars_1m[i].timestamp;
+    c.is_complete = true;
+    fine.push(c);
+  }
+}
+
+static void checkRebuild(const fixture_bar_t *want, size_t count,
+                         int seconds) {
+  CandleResampler::rebuild(fine, 60, coarse, seconds);
+  TEST_ASSERT_EQUAL_INT(count, coarse.size());
+
+  for (size_t i = 0; i < count; i++) {
+    // The fixture is oldest first, the store is addressed newest first
+    enhanced_candle_t c = coarse.get(count - 1 - i);
+    TEST_ASSERT_EQUAL_INT32(want[i].timestamp, c.timestamp);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001, want[i].open, c.open);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001, want[i].high, c.high);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001, want[i].low, c.low);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001, want[i].close, c.close);
+    TEST_ASSERT_EQUAL_UINT32(want[i].volume, c.volume);
+    TEST_ASSERT_EQUAL(i + 1 < count, c.is_complete);
+  }
+}
+
+void setUp() {
+  setenv("TZ", TIME_ZONE, 1);
+  tzset();
+  loadFine();
+}
+void tearDown() {}
+
+void test_session_open_alignment() {
+  // Pre-market minutes floor to buckets before the open, not after it
+  TEST_ASSERT_EQUAL_INT32(SESSION_OPEN,
+                          CandleResampler::bucketStart(SESSION_OPEN, 300));
+  TEST_ASSERT_EQUAL_INT32(SESSION_OPEN - 300,
+                          CandleResampler::bucketStart(SESSION_OPEN - 1, 300));
+  TEST_ASSERT_EQUAL_INT32(
+      SESSION_OPEN - 900,
+      CandleResampler::bucketStart(SESSION_OPEN - 480, 900));
+  TEST_ASSERT_EQUAL_INT32(
+      SESSION_OPEN + 3600,
+      CandleResampler::bucketStart(SESSION_OPEN + 3659, 3600));
+  TEST_ASSERT_EQUAL_INT32(
+      SESSION_OPEN, CandleResampler::bucketStart(SESSION_OPEN + 7200, 86400));
+}
+
+void test_rebuild_5m() { checkRebuild(bars_5m, COUNT(bars_5m), 300); }
+
+void test_rebuild_15m() { checkRebuild(bars_15m, COUNT(bars_15m), 900); }
+
+void test_last_bucket_completes() {
+  // Fill the open 15m bucket through 07:14, its last minute
+  enhanced_candle_t c = fine.get(0);
+  while (c.timestamp < SESSION_OPEN + 44 * 60) {
+    c.timestamp += 60;
+    fine.push(c);
+  }
+  CandleResampler::rebuild(fine, 60, coarse, 900);
+  TEST_ASSERT_TRUE(coarse.isComplete(0));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  fine.allocate(64);
+  coarse.allocate(16);
+  RUN_TEST(test_session_open_alignment);
+  RUN_TEST(test_rebuild_5m);
+  RUN_TEST(test_rebuild_15m);
+  RUN_TEST(test_last_bucket_completes);
+  return UNITY_END();
+}
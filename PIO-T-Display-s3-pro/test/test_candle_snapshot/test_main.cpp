@@ -0,0 +1,146 @@
+// CandleSnapshot::encode()/decode() round trip, and rejection of damaged
+// images
+//
+//   pio test -e native_test -f test_candle_snapshot
+
+#include "candle_snapshot.h"
+#include <unity.h>
+#include <vector>
+
+#define BARS 70
+
+static CandleStore source;
+static CandleStore restored;
+static std::vector<uint8_t> image;
+
+static void fillSource() {
+  source.clear();
+  for (int i = 0; i < BARS; i++) {
+    enhanced_candle_t c;
+    c.open = 512.40f + (i % 7) * 0.13f;
+    c.close = 512.40f + (i % 5) * 0.11f;
+    c.high = std::max(c.open, c.close) + 0.05f;
+    c.low = std::min(c.open, c.close) - 0.07f;
+    c.volume = 1000 + i * 37;
+    c.timestamp = 1710250200 + i * 60;
+    c.is_complete = i < BARS - 1;
+    // Yahoo's null bars arrive as zero prices
+    if (i == 55) {
+      c.open = c.high = c.low = c.close = 0;
+    }
+    source.push(c);
+  }
+}
+
+// One column of the newest `bars` bars, oldest first, unwrapped
+static std::vector<uint8_t> columnOf(const CandleStore &store,
+                                     candle_column_t column, int bars) {
+  int starts[2], lengths[2];
+  int runs = store.runs(bars, starts, lengths);
+  size_t width = CandleStore::columnWidth(column);
+  std::vector<uint8_t> out;
+  for (int r = 0; r < runs; r++) {
+    const uint8_t *data = store.columnData(column) + starts[r] * width;
+    out.insert(out.end(), data, data + lengths[r] * width);
+  }
+  return out;
+}
+
+static void assertSameColumns(const CandleStore &want,
+                              const CandleStore &got) {
+  // Bit for bit: the snapshot carries the store's ticks and base as is
+  TEST_ASSERT_EQUAL_DOUBLE(want.basePrice(), got.basePrice());
+  TEST_ASSERT_EQUAL_INT32(want.baseTime(), got.baseTime());
+  for (int col = 0; col < CANDLE_COL_COUNT; col++) {
+    std::vector<uint8_t> a = columnOf(want, (candle_column_t)col, got.size());
+    std::vector<uint8_t> b = columnOf(got, (candle_column_t)col, got.size());
+    TEST_ASSERT_EQUAL(a.size(), b.size());
+    TEST_ASSERT_EQUAL_MEMORY(a.data(), b.data(), a.size());
+  }
+}
+
+static time_t decodeImage(size_t len) {
+  return CandleSnapshot::decode(image.data(), len, "SPY", "1m", restored);
+}
+
+void setUp() {
+  fillSource();
+  image.assign(CandleSnapshot::encodedSize(source.size()), 0);
+  TEST_ASSERT_EQUAL(image.size(),
+                    CandleSnapshot::encode(source, "SPY", "1m", image.data()));
+  restored.clear();
+}
+void tearDown() {}
+
+void test_round_trip() {
+  TEST_ASSERT_EQUAL_INT32(source.timestamp(0), decodeImage(image.size()));
+  TEST_ASSERT_EQUAL_INT(source.size(), restored.size());
+
+  assertSameColumns(source, restored);
+
+  // The extrema index is rebuilt from the loaded columns
+  float want_low, want_high, low, high;
+  TEST_ASSERT_TRUE(source.extremaOf(source.size(), &want_low, &want_high));
+  TEST_ASSERT_TRUE(restored.extremaOf(restored.size(), &low, &high));
+  TEST_ASSERT_EQUAL_FLOAT(want_low, low);
+  TEST_ASSERT_EQUAL_FLOAT(want_high, high);
+
+  // Null prices survive as null prices
+  TEST_ASSERT_EQUAL_FLOAT(0, restored.get(BARS - 1 - 55).close);
+}
+
+void test_smaller_store_keeps_newest() {
+  CandleStore small;
+  TEST_ASSERT_TRUE(small.allocate(10));
+  TEST_ASSERT_EQUAL_INT32(source.timestamp(0),
+                          CandleSnapshot::decode(image.data(), image.size(),
+                                                 "SPY", "1m", small));
+  TEST_ASSERT_EQUAL_INT(10, small.size());
+  assertSameColumns(source, small);
+}
+
+void test_flipped_byte() {
+  // Magic, version, symbol, interval, the CRC itself, three columns and
+  // the last complete flag
+  size_t columns = sizeof(snapshot_header_t);
+  size_t offsets[] = {0, 4, 8, 24, sizeof(snapshot_header_t) - 1,
+                      columns, columns + BARS * 4 + 3, columns + BARS * 17,
+                      image.size() - 1};
+  for (size_t offset : offsets) {
+    image[offset] ^= 0x10;
+    TEST_ASSERT_EQUAL_INT32(0, decodeImage(image.size()));
+    image[offset] ^= 0x10;
+  }
+  TEST_ASSERT_EQUAL_INT32(source.timestamp(0), decodeImage(image.size()));
+}
+
+void test_truncated() {
+  size_t lengths[] = {0, 4, sizeof(snapshot_header_t) - 1,
+                      sizeof(snapshot_header_t), image.size() / 2,
+                      image.size() - 1};
+  for (size_t len : lengths) {
+    TEST_ASSERT_EQUAL_INT32(0, decodeImage(len));
+  }
+}
+
+void test_other_series() {
+  TEST_ASSERT_EQUAL_INT32(0, CandleSnapshot::decode(image.data(),
+                                                    image.size(), "QQQ",
+                                                    "1m", restored));
+  TEST_ASSERT_EQUAL_INT32(0, CandleSnapshot::decode(image.data(),
+                                                    image.size(), "SPY",
+                                                    "5m", restored));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  // Smaller than BARS, so the source has wrapped its ring
+  source.allocate(64);
+  restored.allocate(64);
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_smaller_store_keeps_newest);
+  RUN_TEST(test_flipped_byte);
+  RUN_TEST(test_truncated);
+  RUN_TEST(test_other_series);
+  return UNITY_END();
+}
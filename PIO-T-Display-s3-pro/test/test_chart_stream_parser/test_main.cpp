@@ -0,0 +1,111 @@
+// ChartStreamParser::parse() on complete and cut-off Yahoo chart bodies
+//
+//   pio test -e native_test -f test_chart_stream_parser
+
+#include "chart_stream_parser.h"
+#include <Client.h>
+#include <algorithm>
+#include <unity.h>
+
+#define ROWS_MAX 8
+
+// Serves a fixed body, then reads as a closed connection
+class BodyClient : public Client {
+private:
+  const char *data;
+  size_t len;
+  size_t pos;
+
+public:
+  BodyClient(const char *body) : data(body), len(strlen(body)), pos(0) {}
+
+  int available() override { return len - pos; }
+  int read(uint8_t *buf, size_t size) override {
+    size_t n = std::min(size, len - pos);
+    memcpy(buf, data + pos, n);
+    pos += n;
+    return n;
+  }
+  int read() override { return (pos < len) ? data[pos++] : -1; }
+  int peek() override { return (pos < len) ? data[pos] : -1; }
+  uint8_t connected() override { return pos < len; }
+
+  int connect(IPAddress ip, uint16_t port) override { return 0; }
+  int connect(const char *host, uint16_t port) override { return 0; }
+  size_t write(uint8_t) override { return 0; }
+  size_t write(const uint8_t *buf, size_t size) override { return 0; }
+  void flush() override {}
+  void stop() override {}
+  operator bool() override { return true; }
+};
+
+static double values[CHART_FIELD_COUNT][ROWS_MAX];
+
+static void storeValue(ChartField field, uint32_t index, double value,
+                       void *ctx) {
+  if (index < ROWS_MAX) {
+    values[field][index] = value;
+  }
+}
+
+static bool parseBody(const char *body, ChartStreamParser &parser) {
+  memset(values, 0, sizeof(values));
+  BodyClient client(body);
+  return parser.parse(client, 100);
+}
+
+#define BODY_HEAD                                                              \
+  "{\"chart\":{\"result\":[{\"meta\":{\"symbol\":\"SPY\"},"                    \
+  "\"timestamp\":[1700000000,1700000060],\"indicators\":{\"quote\":[{"        \
+  "\"open\":[251.0,251.2],\"high\":[251.5,251.6],\"low\":[250.9,251.1],"
+
+void setUp() {}
+void tearDown() {}
+
+void test_complete_body() {
+  ChartStreamParser parser(storeValue, NULL);
+  TEST_ASSERT_TRUE(parseBody(BODY_HEAD "\"close\":[251.37,251.5],"
+                                       "\"volume\":[1200,900]}]}}],"
+                                       "\"error\":null}}",
+                             parser));
+  TEST_ASSERT_EQUAL_UINT32(2, parser.getRowCount());
+  TEST_ASSERT_EQUAL_DOUBLE(251.5, values[CHART_FIELD_CLOSE][1]);
+  TEST_ASSERT_EQUAL_DOUBLE(900, values[CHART_FIELD_VOLUME][1]);
+}
+
+void test_body_without_volume() {
+  ChartStreamParser parser(storeValue, NULL);
+  TEST_ASSERT_TRUE(parseBody(
+      BODY_HEAD "\"close\":[251.37,251.5]}]}}],\"error\":null}}", parser));
+  TEST_ASSERT_EQUAL_UINT32(2, parser.getRowCount());
+}
+
+void test_truncated_mid_number() {
+  // The cut leaves "25" of 251.5; it must never reach the sink
+  ChartStreamParser parser(storeValue, NULL);
+  TEST_ASSERT_FALSE(parseBody(BODY_HEAD "\"close\":[251.37,25", parser));
+  TEST_ASSERT_EQUAL_UINT32(1, parser.getCount(CHART_FIELD_CLOSE));
+  TEST_ASSERT_EQUAL_DOUBLE(0, values[CHART_FIELD_CLOSE][1]);
+}
+
+void test_truncated_between_values() {
+  ChartStreamParser parser(storeValue, NULL);
+  TEST_ASSERT_FALSE(parseBody(BODY_HEAD "\"close\":[251.37,", parser));
+}
+
+void test_truncated_in_volume() {
+  ChartStreamParser parser(storeValue, NULL);
+  TEST_ASSERT_FALSE(
+      parseBody(BODY_HEAD "\"close\":[251.37,251.5],\"volume\":[1200",
+                parser));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_complete_body);
+  RUN_TEST(test_body_without_volume);
+  RUN_TEST(test_truncated_mid_number);
+  RUN_TEST(test_truncated_between_values);
+  RUN_TEST(test_truncated_in_volume);
+  return UNITY_END();
+}
@@ -0,0 +1,218 @@
+// EventStream's ring and non-blocking flush() over loopback TCP sockets
+//
+//   pio test -e native_test -f test_event_stream
+
+#include "event_stream.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unity.h>
+#include <vector>
+
+#define SMALL_BUFFER 2048 // Rounded up to the kernel minimum
+#define SMALL_MSS 536      // Loopback's 64K MSS would hold a small window shut
+
+// Same sequence every run so a failure can be replayed
+static uint32_t rng = 12345;
+static uint32_t nextRandom(uint32_t range) {
+  rng = rng * 1664525u + 1013904223u;
+  return (rng >> 8) % range;
+}
+
+// Connected loopback pair, as lwIP would hand the web server. The server
+// end goes to EventStream; the test reads the other. Small buffers let
+// the TCP window fill part way through a message.
+static WiFiClient openPair(int &peer) {
+  int size = SMALL_BUFFER;
+  int mss = SMALL_MSS;
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  setsockopt(listener, IPPROTO_TCP, TCP_MAXSEG, &mss, sizeof(mss));
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof(addr);
+  TEST_ASSERT_EQUAL(0, bind(listener, (struct sockaddr *)&addr, addr_len));
+  TEST_ASSERT_EQUAL(0, listen(listener, 1));
+  getsockname(listener, (struct sockaddr *)&addr, &addr_len);
+
+  peer = socket(AF_INET, SOCK_STREAM, 0);
+  setsockopt(peer, IPPROTO_TCP, TCP_MAXSEG, &mss, sizeof(mss));
+  setsockopt(peer, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  TEST_ASSERT_EQUAL(0, connect(peer, (struct sockaddr *)&addr, addr_len));
+  fcntl(peer, F_SETFL, O_NONBLOCK);
+
+  int fd = accept(listener, NULL, NULL);
+  close(listener);
+  setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+  return WiFiClient(fd);
+}
+
+// Reads up to max bytes without waiting; false once the server has closed
+static bool readSome(int peer, std::string &out, size_t max) {
+  char buf[512];
+  while (max > 0) {
+    ssize_t n = recv(peer, buf, std::min(max, sizeof(buf)), 0);
+    if (n == 0) {
+      return false;
+    }
+    if (n < 0) {
+      return true;
+    }
+    out.append(buf, n);
+    max -= n;
+  }
+  return true;
+}
+
+static void publishTick(long t) {
+  enhanced_candle_t candle = {100.0f, 101.0f, 102.0f, 99.0f, 1000,
+                              (time_t)t, false};
+  EventStream::publish("TEST", candle, 101.0f);
+}
+
+// Splits the body after the HTTP header into tick timestamps. Every
+// message must arrive whole and in order; only the last may be cut off,
+// and only when the server closed the client.
+static std::vector<long> parseTicks(const std::string &bytes, bool closed) {
+  size_t pos = bytes.find("retry: 3000\n\n");
+  TEST_ASSERT_TRUE(pos != std::string::npos);
+  pos += strlen("retry: 3000\n\n");
+
+  std::vector<long> ticks;
+  while (pos < bytes.size()) {
+    size_t end = bytes.find("\n\n", pos);
+    if (end == std::string::npos) {
+      TEST_ASSERT_TRUE_MESSAGE(closed, "Truncated message on a live stream");
+      break;
+    }
+    std::string message = bytes.substr(pos, end + 2 - pos);
+    long t;
+    int fields = sscanf(message.c_str(),
+                        "event: tick\ndata: {\"s\":\"TEST\",\"t\":%ld,", &t);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, fields, message.c_str());
+    TEST_ASSERT_EQUAL('}', message[message.size() - 3]);
+    if (!ticks.empty()) {
+      TEST_ASSERT_TRUE(t > ticks.back());
+    }
+    ticks.push_back(t);
+    pos = end + 2;
+  }
+  return ticks;
+}
+
+// Serves until the peer has everything EventStream holds for it
+static bool drain(int peer, std::string &out) {
+  for (int i = 0; i < 1000; i++) {
+    EventStream::service();
+    if (!readSome(peer, out, SIZE_MAX)) {
+      return false;
+    }
+    if (EventStream::clientCount() == 0) {
+      readSome(peer, out, SIZE_MAX);
+      return false;
+    }
+    usleep(100);
+  }
+  return true;
+}
+
+void setUp() { rng = 12345; }
+void tearDown() { EventStream::closeAll(); }
+
+void test_lagging_client_skips_oldest() {
+  publishTick(0); // Replayed on accept, then overtaken
+  int peer;
+  TEST_ASSERT_TRUE(EventStream::accept(openPair(peer)));
+
+  uint32_t dropped = EventStream::getStats().dropped;
+  for (long t = 1; t <= 3 * EVENT_RING_DEPTH; t++) {
+    publishTick(t);
+  }
+
+  std::string bytes;
+  TEST_ASSERT_TRUE(drain(peer, bytes));
+  std::vector<long> ticks = parseTicks(bytes, false);
+
+  // Exactly the newest ring's worth, oldest first
+  TEST_ASSERT_EQUAL(EVENT_RING_DEPTH, ticks.size());
+  TEST_ASSERT_EQUAL(2 * EVENT_RING_DEPTH + 1, ticks.front());
+  TEST_ASSERT_EQUAL(3 * EVENT_RING_DEPTH, ticks.back());
+  TEST_ASSERT_EQUAL(2 * EVENT_RING_DEPTH + 1,
+                    EventStream::getStats().dropped - dropped);
+  close(peer);
+}
+
+void test_partial_sends_reassemble() {
+  publishTick(1000);
+  int peer;
+  TEST_ASSERT_TRUE(EventStream::accept(openPair(peer)));
+  uint32_t dropped = EventStream::getStats().dropped;
+
+  // The reader takes a little under a message per tick on average, then
+  // catches up in bursts, so the window keeps filling part way through
+  std::string bytes;
+  bool open = true;
+  const long ticks_sent = 4000;
+  for (long t = 1; t <= ticks_sent && open; t++) {
+    publishTick(1000 + t);
+    EventStream::service();
+    size_t take = (t % 50 < 40) ? nextRandom(200) : SIZE_MAX;
+    open = readSome(peer, bytes, take) && EventStream::clientCount() > 0;
+  }
+  if (open) {
+    open = drain(peer, bytes);
+  }
+
+  std::vector<long> ticks = parseTicks(bytes, !open);
+  TEST_ASSERT_TRUE(ticks.size() > 0);
+  if (open) {
+    // Every gap is a message counted as dropped, none went missing
+    long expected = ticks_sent + 1;
+    TEST_ASSERT_EQUAL(1000 + ticks_sent, ticks.back());
+    TEST_ASSERT_EQUAL(expected - (long)ticks.size(),
+                      EventStream::getStats().dropped - dropped);
+  }
+  close(peer);
+}
+
+void test_stalled_client_does_not_block() {
+  int peer;
+  TEST_ASSERT_TRUE(EventStream::accept(openPair(peer)));
+
+  // Nothing is read, so the socket fills and stays full
+  unsigned long start = millis();
+  for (long t = 1; t <= 1000; t++) {
+    publishTick(10000 + t);
+    EventStream::service();
+  }
+  unsigned long elapsed = millis() - start;
+  TEST_ASSERT_TRUE_MESSAGE(elapsed < 500, "service() waited on the socket");
+
+  // Stuck between messages it is still served, newest ring first; stuck
+  // mid-message it was closed, with no foreign bytes spliced in
+  std::string bytes;
+  bool open = drain(peer, bytes);
+  std::vector<long> ticks = parseTicks(bytes, !open);
+  if (open) {
+    TEST_ASSERT_EQUAL(11000, ticks.back());
+  }
+  TEST_ASSERT_TRUE(ticks.size() < 1000);
+  close(peer);
+}
+
+int main(int argc, char **argv) {
+  // A closed peer must fail send() with EPIPE, as lwIP does, not kill us
+  signal(SIGPIPE, SIG_IGN);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_lagging_client_skips_oldest);
+  RUN_TEST(test_partial_sends_reassemble);
+  RUN_TEST(test_stalled_client_does_not_block);
+  return UNITY_END();
+}
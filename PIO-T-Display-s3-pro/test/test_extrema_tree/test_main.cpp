@@ -0,0 +1,144 @@
+// ExtremaTree and CandleStore::extremaOf against a linear scan
+//
+//   pio test -e native_test -f test_extrema_tree
+
+#include "candle_store.h"
+#include "extrema_tree.h"
+#include <algorithm>
+#include <limits>
+#include <unity.h>
+#include <vector>
+
+#define RUNS 2000
+
+// Same sequence every run so a failure can be replayed
+static uint32_t rng = 12345;
+static uint32_t nextRandom(uint32_t range) {
+  rng = rng * 1664525u + 1013904223u;
+  return (rng >> 8) % range;
+}
+
+void setUp() { rng = 12345; }
+void tearDown() {}
+
+void test_tree_matches_scan() {
+  // Slot counts on both sides of a power of two
+  const size_t slot_counts[] = {1, 7, 64, 100};
+  for (size_t slots : slot_counts) {
+    std::vector<int32_t> low_nodes(ExtremaTree<int32_t>::nodesFor(slots));
+    std::vector<int32_t> high_nodes(low_nodes.size());
+    ExtremaTree<int32_t> tree;
+    tree.attach(low_nodes.data(), high_nodes.data(), slots);
+
+    std::vector<bool> filled(slots, false);
+    std::vector<int32_t> lows(slots), highs(slots);
+
+    for (int run = 0; run < RUNS; run++) {
+      size_t slot = nextRandom(slots);
+      if (nextRandom(5) == 0) {
+        tree.erase(slot);
+        filled[slot] = false;
+      } else {
+        lows[slot] = (int32_t)nextRandom(200000) - 100000;
+        highs[slot] = lows[slot] + (int32_t)nextRandom(5000);
+        tree.set(slot, lows[slot], highs[slot]);
+        filled[slot] = true;
+      }
+
+      size_t first = nextRandom(slots);
+      size_t last = first + nextRandom(slots - first);
+      int32_t low = std::numeric_limits<int32_t>::max();
+      int32_t high = std::numeric_limits<int32_t>::lowest();
+      tree.query(first, last, &low, &high);
+
+      int32_t want_low = std::numeric_limits<int32_t>::max();
+      int32_t want_high = std::numeric_limits<int32_t>::lowest();
+      for (size_t i = first; i <= last; i++) {
+        if (filled[i]) {
+          want_low = std::min(want_low, lows[i]);
+          want_high = std::max(want_high, highs[i]);
+        }
+      }
+      TEST_ASSERT_EQUAL_INT32(want_low, low);
+      TEST_ASSERT_EQUAL_INT32(want_high, high);
+    }
+  }
+}
+
+// Bars with any missing price are left out, as in CandleStore::write()
+static bool scanExtrema(const CandleStore &store, int bars, float *low,
+                        float *high) {
+  bool found = false;
+  for (int age = 0; age < bars; age++) {
+    enhanced_candle_t c = store.get(age);
+    if (c.open <= 0 || c.high <= 0 || c.low <= 0 || c.close <= 0) {
+      continue;
+    }
+    *low = found ? std::min(*low, c.low) : c.low;
+    *high = found ? std::max(*high, c.high) : c.high;
+    found = true;
+  }
+  return found;
+}
+
+static enhanced_candle_t randomCandle(time_t timestamp) {
+  enhanced_candle_t c;
+  c.open = 250.0f + nextRandom(1000) / 100.0f;
+  c.close = 250.0f + nextRandom(1000) / 100.0f;
+  c.low = std::min(c.open, c.close) - nextRandom(100) / 100.0f;
+  c.high = std::max(c.open, c.close) + nextRandom(100) / 100.0f;
+  // Yahoo's null bars arrive as zero prices
+  if (nextRandom(10) == 0) {
+    c.low = 0;
+  }
+  c.volume = nextRandom(10000);
+  c.timestamp = timestamp;
+  c.is_complete = true;
+  return c;
+}
+
+void test_store_matches_scan() {
+  CandleStore store;
+  TEST_ASSERT_TRUE(store.allocate(50));
+
+  // Several laps of the ring, so windows wrap at every offset
+  time_t timestamp = 1700000000;
+  for (int bar = 0; bar < 173; bar++) {
+    store.push(randomCandle(timestamp));
+    timestamp += 60;
+    if (nextRandom(4) == 0) {
+      int age = nextRandom(store.size());
+      store.replace(age, randomCandle(store.timestamp(age)));
+    }
+
+    for (int bars = 1; bars <= store.size(); bars++) {
+      float low = 0, high = 0, want_low = 0, want_high = 0;
+      bool found = store.extremaOf(bars, &low, &high);
+      TEST_ASSERT_EQUAL(scanExtrema(store, bars, &want_low, &want_high),
+                        found);
+      if (found) {
+        TEST_ASSERT_EQUAL_FLOAT(want_low, low);
+        TEST_ASSERT_EQUAL_FLOAT(want_high, high);
+      }
+    }
+  }
+}
+
+void test_store_all_gaps() {
+  CandleStore store;
+  TEST_ASSERT_TRUE(store.allocate(8));
+  enhanced_candle_t gap = randomCandle(1700000000);
+  gap.close = 0;
+  store.push(gap);
+
+  float low, high;
+  TEST_ASSERT_FALSE(store.extremaOf(1, &low, &high));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_tree_matches_scan);
+  RUN_TEST(test_store_matches_scan);
+  RUN_TEST(test_store_all_gaps);
+  return UNITY_END();
+}
@@ -0,0 +1,244 @@
+// The real FetchTask and DataFetcher against an in-process HTTP server that
+// dribbles chart bodies and stalls part way: the UI side must keep
+// draining batches meanwhile, and batches of a superseded load must never
+// reach the store
+//
+//   pio test -e native_test -f test_fetch_pipeline
+
+#include "config.h"
+#include "data_fetcher.h"
+#include "fetch_task.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <math.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unity.h>
+
+#define BARS 390          // One session of 1m bars
+#define BODY_CHUNK 1024   // Bytes the server sends at a time
+#define BODY_GAP_MS 2     // ...with this pause between them
+#define STALL_MS 1500     // Silence half way through a stalled body
+#define LOAD_TIMEOUT_MS 10000
+#define MAX_UPDATE_US 20000 // Far above one batch, far below one stall
+
+static int server_port = 0;
+static std::atomic<bool> stalling{false};
+static std::atomic<int> bodies_sent{0};
+
+// A Yahoo v8 chart body of BARS one-minute bars ending now, all closing
+// near `price` so the test can tell two symbols' bars apart
+static std::string chartBody(float price) {
+  std::string timestamps, open, high, low, close, volume;
+  time_t start = time(nullptr) / 60 * 60 - (BARS - 1) * 60;
+  char value[32];
+  for (int i = 0; i < BARS; i++) {
+    const char *sep = (i == 0) ? "" : ",";
+    float wobble = (float)((i * 7919) % 201 - 100) / 100.0f;
+    snprintf(value, sizeof(value), "%s%ld", sep, (long)(start + i * 60));
+    timestamps += value;
+    snprintf(value, sizeof(value), "%s%.4f", sep, price);
+    open += value;
+    snprintf(value, sizeof(value), "%s%.4f", sep, price + 2.0f);
+    high += value;
+    snprintf(value, sizeof(value), "%s%.4f", sep, price - 2.0f);
+    low += value;
+    snprintf(value, sizeof(value), "%s%.4f", sep, price + wobble);
+    close += value;
+    snprintf(value, sizeof(value), "%s%d", sep, 1000 + i);
+    volume += value;
+  }
+  return "{\"chart\":{\"result\":[{\"meta\":{\"currency\":\"USD\"},"
+         "\"timestamp\":[" +
+         timestamps + "],\"indicators\":{\"quote\":[{\"open\":[" + open +
+         "],\"high\":[" + high + "],\"low\":[" + low + "],\"close\":[" +
+         close + "],\"volume\":[" + volume + "]}]}}],\"error\":null}}";
+}
+
+static bool sendAll(int fd, const char *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    len -= n;
+  }
+  return true;
+}
+
+// Keep-alive HTTP/1.1 on one connection. Initial loads (range=) of the
+// chart get a body near 100, or near 500 for symbols starting with N, and
+// stall half way for symbols starting with S. Polls and anything else get
+// an empty 404.
+static void serveConnection(int fd) {
+  std::string buffer;
+  char chunk[1024];
+  for (;;) {
+    size_t end;
+    while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+      ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+      if (n <= 0) {
+        close(fd);
+        return;
+      }
+      buffer.append(chunk, n);
+    }
+    std::string request = buffer.substr(0, end);
+    buffer.erase(0, end + 4);
+
+    size_t path_start = request.find("/v8/finance/chart/");
+    if (path_start == std::string::npos ||
+        request.find("range=") == std::string::npos) {
+      const char *missing = "HTTP/1.1 404 Not Found\r\n"
+                            "Content-Length: 0\r\n\r\n";
+      sendAll(fd, missing, strlen(missing));
+      continue;
+    }
+    path_start += strlen("/v8/finance/chart/");
+    std::string symbol =
+        request.substr(path_start, request.find('?', path_start) - path_start);
+    std::string body = chartBody(symbol[0] == 'N' ? 500.0f : 100.0f);
+    bool stall = (symbol[0] == 'S');
+
+    snprintf(chunk, sizeof(chunk),
+             "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+             "Content-Length: %u\r\n\r\n",
+             (unsigned)body.size());
+    sendAll(fd, chunk, strlen(chunk));
+    for (size_t at = 0; at < body.size(); at += BODY_CHUNK) {
+      if (stall && at >= body.size() / 2) {
+        stalling = true;
+        usleep(STALL_MS * 1000);
+        stalling = false;
+        stall = false;
+      }
+      size_t n = std::min((size_t)BODY_CHUNK, body.size() - at);
+      if (!sendAll(fd, body.data() + at, n)) {
+        close(fd);
+        return;
+      }
+      usleep(BODY_GAP_MS * 1000);
+    }
+    bodies_sent++;
+  }
+}
+
+static void startServer() {
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof(addr);
+  bind(listener, (struct sockaddr *)&addr, addr_len);
+  listen(listener, 4);
+  getsockname(listener, (struct sockaddr *)&addr, &addr_len);
+  server_port = ntohs(addr.sin_port);
+
+  std::thread([listener]() {
+    for (;;) {
+      int fd = accept(listener, NULL, NULL);
+      if (fd >= 0) {
+        std::thread(serveConnection, fd).detach();
+      }
+    }
+  }).detach();
+}
+
+// Runs the UI side's per-frame update until `done` or the timeout, and
+// returns the longest single call in microseconds
+template <typename Check>
+static unsigned long runUpdates(Check done, int *calls) {
+  unsigned long longest = 0;
+  unsigned long start = millis();
+  *calls = 0;
+  while (!done() && millis() - start < LOAD_TIMEOUT_MS) {
+    unsigned long call_start = micros();
+    DataFetcher::updateData();
+    longest = std::max(longest, micros() - call_start);
+    (*calls)++;
+    delay(1);
+  }
+  return longest;
+}
+
+static bool holdsLoad(float price) {
+  return DataFetcher::getCandleCount() == BARS &&
+         fabsf(DataFetcher::getCandle(0).close - price) < 2.0f;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_stalled_body_does_not_block_updates() {
+  int bodies_before = bodies_sent;
+  unsigned long start = millis();
+  TEST_ASSERT_TRUE(DataFetcher::initialize("SLOW"));
+
+  int calls;
+  unsigned long longest = runUpdates([]() { return holdsLoad(100.0f); },
+                                     &calls);
+  unsigned long elapsed = millis() - start;
+
+  TEST_ASSERT_TRUE_MESSAGE(holdsLoad(100.0f), "Load never arrived");
+  TEST_ASSERT_EQUAL(bodies_before + 1, bodies_sent);
+  // The load really did wait on the stall, and the UI side kept running
+  // through it without ever waiting on the socket
+  TEST_ASSERT_TRUE(elapsed >= STALL_MS);
+  TEST_ASSERT_TRUE(calls > STALL_MS / 2);
+  TEST_ASSERT_TRUE_MESSAGE(longest < MAX_UPDATE_US,
+                           "updateData() waited on the fetch");
+}
+
+void test_superseded_load_is_dropped() {
+  int bodies_before = bodies_sent;
+  TEST_ASSERT_TRUE(DataFetcher::initialize("STALE"));
+
+  // Switch while the old body is stuck half way; the fetch task finishes
+  // reading it and publishes its batches under the old generation
+  int calls;
+  runUpdates([]() { return stalling.load(); }, &calls);
+  TEST_ASSERT_TRUE_MESSAGE(stalling.load(), "Old body never stalled");
+  TEST_ASSERT_TRUE(DataFetcher::initialize("NEW"));
+
+  bool saw_old = false;
+  unsigned long start = millis();
+  while (!holdsLoad(500.0f) && millis() - start < LOAD_TIMEOUT_MS) {
+    DataFetcher::updateData();
+    if (DataFetcher::getCandleCount() > 0 &&
+        DataFetcher::getCandle(0).close < 300.0f) {
+      saw_old = true;
+    }
+    delay(1);
+  }
+
+  TEST_ASSERT_FALSE_MESSAGE(saw_old, "A bar of the superseded load shown");
+  TEST_ASSERT_TRUE_MESSAGE(holdsLoad(500.0f), "New load never arrived");
+  // Both bodies went out in full, so the old batches were made and dropped
+  TEST_ASSERT_EQUAL(bodies_before + 2, bodies_sent);
+}
+
+int main(int argc, char **argv) {
+  signal(SIGPIPE, SIG_IGN);
+  startServer();
+
+  char url[DATA_BASE_URL_CHARS];
+  snprintf(url, sizeof(url), "http://127.0.0.1:%d", server_port);
+  DATA_BASE_URL = url;
+  USE_TEST_DATA = false;
+  ENFORCE_MARKET_HOURS = false;
+  WATCHLIST = "";
+  YAHOO_INTERVAL = "1m";
+  YAHOO_RANGE = "1d";
+  FetchTask::begin();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_stalled_body_does_not_block_updates);
+  RUN_TEST(test_superseded_load_is_dropped);
+  return UNITY_END();
+}
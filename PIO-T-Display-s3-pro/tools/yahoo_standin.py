@@ -0,0 +1,371 @@
+"""Local stand-in for the Yahoo Finance chart and spark endpoints.
+
+Serves /v8/finance/chart/<symbol> and /v7/finance/spark over plain HTTP/1.1
+with keep-alive, so the device (or the native host build) can be pointed at
+it through the Data Source URL setting. Responses come from captured chart
+JSON when a fixture exists, otherwise from a deterministic synthetic series.
+
+Faults are injected per request from a seeded generator, so the same run
+against the same client sees the same latency, 429s, truncated bodies and
+null gaps every time:
+
+    python3 tools/yahoo_standin.py --fixtures fixtures --seed 7 \\
+        --latency 150 --jitter 100 --rate-429 0.05 --rate-truncate 0.02 \\
+        --rate-null 0.01 --script 3:429,4:429,9:truncate,12:slow:4000
+
+Capture a fixture from the real service first with:
+
+    python3 tools/yahoo_standin.py --capture SPY --interval 1m --range 5d \\
+        --fixtures fixtures
+
+Counters are served as JSON on /__stats.
+"""
+
+import argparse
+import json
+import math
+import os
+import random
+import threading
+import time
+import urllib.parse
+import urllib.request
+import zlib
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+YAHOO_BASE_URL = "https://query1.finance.yahoo.com"
+INTERVAL_SECONDS = {
+    "1m": 60, "2m": 120, "5m": 300, "15m": 900, "30m": 1800, "60m": 3600,
+    "90m": 5400, "1h": 3600, "1d": 86400, "5d": 432000, "1wk": 604800,
+    "1mo": 2592000, "3mo": 7776000,
+}
+RANGE_SECONDS = {
+    "1d": 86400, "5d": 432000, "1mo": 2592000, "3mo": 7776000,
+    "6mo": 15552000, "1y": 31536000, "2y": 63072000, "5y": 157680000,
+    "10y": 315360000, "ytd": 31536000, "max": 315360000,
+}
+MAX_BARS = 20000  # Cap on any one response, like Yahoo's own limits
+
+
+def interval_seconds(interval):
+    return INTERVAL_SECONDS.get(interval, 60)
+
+
+def noise(symbol, index, salt):
+    """Stable value in [-1, 1) for a symbol, bar and purpose."""
+    h = zlib.crc32(f"{symbol}:{index}:{salt}".encode())
+    return h / 2**31 - 1.0
+
+
+def synthetic_price(symbol, index):
+    base = 50 + zlib.crc32(symbol.encode()) % 450
+    drift = (0.02 * math.sin(index / 390.0) + 0.008 * math.sin(index / 37.0)
+             + 0.003 * math.sin(index / 7.3))
+    return round(base * (1 + drift + 0.0015 * noise(symbol, index, "p")), 2)
+
+
+class Series:
+    """Bars for one symbol and interval, as parallel columns."""
+
+    def __init__(self, symbol, interval):
+        self.symbol = symbol
+        self.interval = interval
+        self.step = interval_seconds(interval)
+
+    def bars(self, start, end, now):
+        """(timestamp, open, high, low, close, volume) rows in [start, end)."""
+        raise NotImplementedError
+
+
+class SyntheticSeries(Series):
+    # Bar k covers [k * step, (k + 1) * step); the newest one is still
+    # forming and moves towards its close as the interval passes
+    def bars(self, start, end, now):
+        first = max(start, now - MAX_BARS * self.step) // self.step
+        last = min(end, now + 1) // self.step
+        rows = []
+        for k in range(first, last + 1):
+            ts = k * self.step
+            if ts < start or ts >= end or ts > now:
+                continue
+            o = synthetic_price(self.symbol, k - 1)
+            c = synthetic_price(self.symbol, k)
+            progress = min(1.0, (now - ts) / self.step)
+            c = round(o + (c - o) * progress, 2)
+            wick = abs(noise(self.symbol, k, "w")) * 0.002 * o * progress
+            h = round(max(o, c) + wick, 2)
+            l = round(min(o, c) - wick, 2)
+            v = int(1000 + 9000 * abs(noise(self.symbol, k, "v")) * progress)
+            rows.append((ts, o, h, l, c, v))
+        return rows
+
+
+class FixtureSeries(Series):
+    """Captured bars replayed in real time.
+
+    The fixture is shifted so the bar at `preload` of the way through lines
+    up with the current bar when the server starts; later bars are released
+    as their time comes, and the series stops growing at the end of the file.
+    """
+
+    def __init__(self, symbol, interval, path, preload, started):
+        super().__init__(symbol, interval)
+        with open(path, encoding="utf-8") as f:
+            result = json.load(f)["chart"]["result"][0]
+        quote = result["indicators"]["quote"][0]
+        self.rows = list(zip(result["timestamp"], quote["open"], quote["high"],
+                             quote["low"], quote["close"], quote["volume"]))
+        anchor = self.rows[int((len(self.rows) - 1) * preload)][0]
+        self.shift = (started // self.step) * self.step - anchor
+
+    def bars(self, start, end, now):
+        rows = []
+        for row in self.rows:
+            ts = row[0] + self.shift
+            if start <= ts < end and ts <= now:
+                rows.append((ts,) + tuple(row[1:]))
+        return rows[-MAX_BARS:]
+
+
+class StandIn:
+    def __init__(self, args):
+        self.args = args
+        self.started = int(time.time())
+        self.lock = threading.Lock()
+        self.series = {}
+        self.request_count = 0
+        self.script = self.parse_script(args.script)
+        self.stats = {"requests": 0, "chart": 0, "spark": 0, "throttled": 0,
+                      "truncated": 0, "null_bars": 0, "bars": 0, "bytes": 0,
+                      "latency_ms": 0}
+
+    @staticmethod
+    def parse_script(script):
+        # "3:429,9:truncate,12:slow:4000" -> {3: ("429", 0), ...}
+        faults = {}
+        for entry in filter(None, (script or "").split(",")):
+            parts = entry.split(":")
+            faults[int(parts[0])] = (parts[1], int(parts[2]) if len(parts) > 2 else 0)
+        return faults
+
+    def series_for(self, symbol, interval):
+        key = (symbol, interval)
+        with self.lock:
+            if key not in self.series:
+                path = os.path.join(self.args.fixtures or "",
+                                    f"{symbol}_{interval}.json")
+                if self.args.fixtures and os.path.exists(path):
+                    print(f"Replaying {path}")
+                    self.series[key] = FixtureSeries(
+                        symbol, interval, path, self.args.preload, self.started)
+                else:
+                    self.series[key] = SyntheticSeries(symbol, interval)
+            return self.series[key]
+
+    def plan(self):
+        """Fault plan for the next request: (index, fault, latency_ms, rng)."""
+        with self.lock:
+            self.request_count += 1
+            index = self.request_count
+        # One generator per request index, so thread timing never changes
+        # which request gets which fault
+        rng = random.Random(self.args.seed * 1000003 + index)
+        latency = self.args.latency + rng.uniform(0, self.args.jitter)
+        fault = None
+        roll = rng.random()
+        if roll < self.args.rate_429:
+            fault = "429"
+        elif roll < self.args.rate_429 + self.args.rate_truncate:
+            fault = "truncate"
+        if index in self.script:
+            fault, value = self.script[index]
+            if fault == "slow":
+                latency, fault = value, None
+        return index, fault, latency, rng
+
+    def count(self, **deltas):
+        with self.lock:
+            for key, value in deltas.items():
+                self.stats[key] += value
+
+    def with_gaps(self, rows, rng):
+        # Yahoo reports bars it has no trades for as nulls, keeping the
+        # timestamp
+        gapped = []
+        for row in rows:
+            if rng.random() < self.args.rate_null:
+                gapped.append((row[0], None, None, None, None, None))
+            else:
+                gapped.append(row)
+        return gapped
+
+    def chart(self, symbol, query, rng):
+        interval = query.get("interval", "1m")
+        now = int(time.time())
+        if "period1" in query:
+            start = int(query["period1"])
+            end = int(query.get("period2", now + 1))
+        else:
+            start = now - RANGE_SECONDS.get(query.get("range", "1d"), 86400)
+            end = now + 1
+        rows = self.with_gaps(self.series_for(symbol, interval)
+                              .bars(start, end, now), rng)
+        closes = [r[4] for r in rows if r[4] is not None]
+        self.count(bars=len(rows), null_bars=sum(r[1] is None for r in rows))
+        return {"chart": {"result": [{
+            "meta": {"currency": "USD", "symbol": symbol,
+                     "regularMarketPrice": closes[-1] if closes else None,
+                     "chartPreviousClose": closes[0] if closes else None,
+                     "dataGranularity": interval,
+                     "range": query.get("range", "")},
+            "timestamp": [r[0] for r in rows],
+            "indicators": {"quote": [{
+                "open": [r[1] for r in rows], "high": [r[2] for r in rows],
+                "low": [r[3] for r in rows], "close": [r[4] for r in rows],
+                "volume": [r[5] for r in rows]}]},
+        }], "error": None}}
+
+    def spark(self, query, rng):
+        interval = query.get("interval", "5m")
+        now = int(time.time())
+        start = now - RANGE_SECONDS.get(query.get("range", "1d"), 86400)
+        results = []
+        for symbol in filter(None, query.get("symbols", "").split(",")):
+            rows = self.with_gaps(self.series_for(symbol, interval)
+                                  .bars(start, now + 1, now), rng)
+            closes = [r[4] for r in rows]
+            known = [c for c in closes if c is not None]
+            results.append({"symbol": symbol, "response": [{
+                "meta": {"symbol": symbol,
+                         "chartPreviousClose": known[0] if known else None},
+                "timestamp": [r[0] for r in rows],
+                "indicators": {"quote": [{"close": closes}]}}]})
+        return {"spark": {"result": results, "error": None}}
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # Keep-alive, like the real endpoints
+    standin = None
+
+    def log_message(self, format, *args):
+        pass  # One line per request is printed in do_GET instead
+
+    def send_body(self, code, body, content_type="application/json"):
+        self.send_response(code)
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        if code == 429:
+            self.send_header("Retry-After", "5")
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        url = urllib.parse.urlsplit(self.path)
+        query = dict(urllib.parse.parse_qsl(url.query))
+        standin = self.standin
+
+        if url.path == "/__stats":
+            with standin.lock:
+                body = json.dumps(standin.stats).encode()
+            self.send_body(200, body)
+            return
+
+        index, fault, latency, rng = standin.plan()
+        standin.count(requests=1, latency_ms=int(latency))
+        time.sleep(latency / 1000.0)
+
+        if fault == "429":
+            standin.count(throttled=1)
+            print(f"#{index} {url.path} -> 429 after {latency:.0f} ms")
+            self.send_body(429, b"Too Many Requests\n", "text/plain")
+            return
+
+        if url.path.startswith("/v8/finance/chart/"):
+            symbol = urllib.parse.unquote(url.path.rsplit("/", 1)[1])
+            standin.count(chart=1)
+            doc = standin.chart(symbol, query, rng)
+        elif url.path == "/v7/finance/spark":
+            standin.count(spark=1)
+            doc = standin.spark(query, rng)
+        else:
+            self.send_body(404, b'{"chart":{"result":null,"error":'
+                                b'{"code":"Not Found"}}}')
+            return
+
+        body = json.dumps(doc, separators=(",", ":")).encode()
+        standin.count(bytes=len(body))
+
+        if fault == "truncate":
+            # Full length advertised, then the connection drops mid-body
+            cut = int(len(body) * rng.uniform(0.1, 0.9))
+            standin.count(truncated=1)
+            print(f"#{index} {self.path} -> truncated at {cut}/{len(body)} "
+                  f"bytes after {latency:.0f} ms")
+            self.send_response(200)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body[:cut])
+            self.wfile.flush()
+            self.close_connection = True
+            return
+
+        print(f"#{index} {self.path} -> 200, {len(body)} bytes after "
+              f"{latency:.0f} ms")
+        self.send_body(200, body)
+
+
+def capture(args):
+    os.makedirs(args.fixtures, exist_ok=True)
+    url = (f"{YAHOO_BASE_URL}/v8/finance/chart/{args.capture}"
+           f"?interval={args.interval}&range={args.range}")
+    request = urllib.request.Request(url, headers={"User-Agent": "Mozilla/5.0"})
+    with urllib.request.urlopen(request) as response:
+        body = response.read()
+    path = os.path.join(args.fixtures, f"{args.capture}_{args.interval}.json")
+    with open(path, "wb") as f:
+        f.write(body)
+    print(f"Captured {len(body)} bytes into {path}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8765)
+    parser.add_argument("--fixtures", help="Directory of <SYMBOL>_<interval>.json")
+    parser.add_argument("--preload", type=float, default=0.5,
+                        help="Fraction of a fixture already in the past at start")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--latency", type=float, default=0,
+                        help="Milliseconds before every response")
+    parser.add_argument("--jitter", type=float, default=0,
+                        help="Extra random milliseconds, 0 to this")
+    parser.add_argument("--rate-429", type=float, default=0)
+    parser.add_argument("--rate-truncate", type=float, default=0)
+    parser.add_argument("--rate-null", type=float, default=0,
+                        help="Fraction of bars sent as null gaps")
+    parser.add_argument("--script",
+                        help="Faults by request number: N:429, N:truncate, "
+                             "N:slow:MS, comma-separated")
+    parser.add_argument("--capture", metavar="SYMBOL",
+                        help="Save a real chart response as a fixture and exit")
+    parser.add_argument("--interval", default="1m")
+    parser.add_argument("--range", default="1d")
+    args = parser.parse_args()
+
+    if args.capture:
+        args.fixtures = args.fixtures or "fixtures"
+        capture(args)
+        return
+
+    Handler.standin = StandIn(args)
+    server = ThreadingHTTPServer((args.host, args.port), Handler)
+    print(f"Stand-in serving on http://{args.host}:{args.port} (seed {args.seed})")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()